@@ -0,0 +1,48 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  UCTAnnulusCache.h
+ *
+ *    Description:  Annulus observables (the 8 regions around a central one)
+ *                  for every cell of the region grid, computed in one sweep
+ *                  over the regions per event.
+ *
+ * =====================================================================================
+ */
+
+#ifndef UCTANNULUSCACHE_W5PJ2KQN
+#define UCTANNULUSCACHE_W5PJ2KQN
+
+#include "L1Trigger/UCT2015/interface/UCTRegionGrid.h"
+
+struct UCTAnnulus {
+  // ET of the highest and second highest neighbor
+  double highestEt;
+  double secondEt;
+  // Neighbors with the MIP bit set, and with (!tauVeto && !mip), not
+  // counting the highest neighbor, as it could be sharing the 2x1.
+  unsigned char mips;
+  unsigned char egFlags;
+  bool highestHasMip;
+  bool highestHasEGFlag;
+};
+
+class UCTAnnulusCache {
+  public:
+    UCTAnnulusCache();
+
+    // Compute the annulus of every cell.  The regions are visited in
+    // collection order, so ties in ET are resolved the same way as a scan
+    // over the full region list.  Only regions present in the grid count.
+    void build(const std::vector<uctcore::Region>& regions,
+        const UCTRegionGrid& grid);
+
+    const UCTAnnulus& at(int gctEta, int gctPhi) const {
+      return annulus_[uctgrid::index(gctEta, gctPhi)];
+    }
+
+  private:
+    UCTAnnulus annulus_[uctgrid::N_CELLS];
+};
+
+#endif /* end of include guard: UCTANNULUSCACHE_W5PJ2KQN */
@@ -0,0 +1,110 @@
+#ifndef UCTARENA_Q8RJ3VWD
+#define UCTARENA_Q8RJ3VWD
+
+/*
+ * =====================================================================================
+ *
+ *       Filename:  UCTArena.h
+ *
+ *    Description:  Monotonic memory arena for per-event scratch storage, and
+ *                  an STL allocator drawing from it.  Memory is handed out by
+ *                  bumping a pointer and is only given back all at once by
+ *                  reset(); the blocks are kept, so once warmed up an event
+ *                  does not touch the global heap at all.
+ *
+ *                  A disabled arena forwards every request to the global heap,
+ *                  so containers using it behave like ordinary ones.
+ *
+ * =====================================================================================
+ */
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+class UCTArena {
+  public:
+    explicit UCTArena(size_t blockSize = 64 * 1024);
+    ~UCTArena();
+
+    void setEnabled(bool enabled) { enabled_ = enabled; }
+    bool enabled() const { return enabled_; }
+
+    void* allocate(size_t bytes, size_t alignment);
+    // Only frees memory when the arena is disabled.
+    void deallocate(void* p);
+
+    // Make all the memory handed out since the last reset available again.
+    // Nothing allocated from the arena may be used afterwards.
+    void reset();
+
+    // Bytes handed out since the last reset, and bytes held in blocks.
+    size_t bytesUsed() const { return used_; }
+    size_t bytesReserved() const;
+
+  private:
+    UCTArena(const UCTArena&);
+    UCTArena& operator=(const UCTArena&);
+
+    struct Block {
+      char* data;
+      size_t size;
+    };
+
+    bool enabled_;
+    size_t blockSize_;
+    std::vector<Block> blocks_;
+    // position of the next allocation
+    size_t current_;
+    size_t offset_;
+    size_t used_;
+};
+
+template<typename T>
+class UCTArenaAllocator {
+  public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    template<typename U> struct rebind {
+      typedef UCTArenaAllocator<U> other;
+    };
+
+    explicit UCTArenaAllocator(UCTArena* arena) : arena_(arena) {}
+    template<typename U>
+    UCTArenaAllocator(const UCTArenaAllocator<U>& other) : arena_(other.arena()) {}
+
+    UCTArena* arena() const { return arena_; }
+
+    pointer allocate(size_type n, const void* = 0) {
+      return static_cast<pointer>(arena_->allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(pointer p, size_type) { arena_->deallocate(p); }
+
+    void construct(pointer p, const T& value) { new (p) T(value); }
+    void destroy(pointer p) { p->~T(); }
+
+    pointer address(reference x) const { return &x; }
+    const_pointer address(const_reference x) const { return &x; }
+    size_type max_size() const { return size_t(-1) / sizeof(T); }
+
+  private:
+    UCTArena* arena_;
+};
+
+template<typename T, typename U>
+bool operator==(const UCTArenaAllocator<T>& a, const UCTArenaAllocator<U>& b) {
+  return a.arena() == b.arena();
+}
+
+template<typename T, typename U>
+bool operator!=(const UCTArenaAllocator<T>& a, const UCTArenaAllocator<U>& b) {
+  return a.arena() != b.arena();
+}
+
+#endif /* end of include guard: UCTARENA_Q8RJ3VWD */
@@ -0,0 +1,68 @@
+#ifndef UCTATTRIBUTEKEYS_D4MT9XRC
+#define UCTATTRIBUTEKEYS_D4MT9XRC
+
+/*
+ * =====================================================================================
+ *
+ *       Filename:  UCTAttributeKeys.h
+ *
+ *    Description:  Interned names of the tuning attributes attached to
+ *                  UCTCandidates.  Interned attributes are stored inline in
+ *                  the candidate, keyed by a one-byte ID, rather than in a
+ *                  std::map<std::string, ...>.
+ *
+ * =====================================================================================
+ */
+
+#include <string>
+
+namespace uctkey {
+
+// The numeric values are written to disk with the candidates, so new keys
+// must be added just before N_KEYS and existing ones never renumbered
+// (that would need a new UCTCandidate ClassVersion, with a read rule in
+// classes_def.xml renumbering the keys of the old one).
+enum Key {
+  rgnEta,
+  rgnPhi,
+  rctEta,
+  rctPhi,
+  rank,
+  gctEta,
+  gctPhi,
+  isIsolated,
+  isEle,
+  isHighPtEle,
+  ellIsolation,
+  tauVeto,
+  mipBit,
+  jetseed_et,
+  neighborN_et,
+  neighborS_et,
+  neighborE_et,
+  neighborW_et,
+  neighborNE_et,
+  neighborSW_et,
+  neighborNW_et,
+  neighborSE_et,
+  associatedSecondRegionMIP,
+  associatedJetPt,
+  associatedRegionEt,
+  associatedSecondRegionEt,
+  associatedThirdRegionEt,
+  puLevelHI,
+  puLevelHIUIC,
+  puLevelPUM0,
+  uncorrectedPt,
+  N_KEYS
+};
+
+// The attribute name of a key.
+const char* name(Key key);
+
+// The key for an attribute name, or N_KEYS if the name is not interned.
+Key lookup(const std::string& name);
+
+}
+
+#endif /* end of include guard: UCTATTRIBUTEKEYS_D4MT9XRC */
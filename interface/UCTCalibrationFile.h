@@ -0,0 +1,128 @@
+#ifndef UCTCALIBRATIONFILE_W5RT8NJC
+#define UCTCALIBRATIONFILE_W5RT8NJC
+
+/*
+ * =====================================================================================
+ *
+ *       Filename:  UCTCalibrationFile.h
+ *
+ *    Description:  Binary file of named calibration tables (the regionSF,
+ *                  regionSubtraction and jetSF vdoubles of regionSF_cfi.py
+ *                  and jetSF_cfi.py), which the modules read instead of
+ *                  taking the tables from their configuration.  They copy
+ *                  the tables they need (get()) when a file is opened and
+ *                  derive their constants from the copies.  A Watcher
+ *                  reopens the file when it is replaced, so that new
+ *                  constants can be picked up by a running job.
+ *
+ *                  Layout, in host byte order: a Header, nTables
+ *                  TableEntries, then the values of each table as doubles.
+ *                  The checksum is the CRC-32 of everything after the
+ *                  header.  Files are made with test/UCTMakeCalibrationFile.
+ *
+ * =====================================================================================
+ */
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <stdint.h>
+#include <sys/types.h>
+
+namespace uctcalib {
+
+const uint32_t VERSION = 1;
+const unsigned int MAX_NAME = 48;
+
+struct Header {
+  char magic[8];                // "UCTCALIB"
+  uint32_t version;
+  uint32_t nTables;
+  uint64_t size;                // of the whole file
+  uint32_t checksum;
+  uint32_t unused;
+};
+
+struct TableEntry {
+  char name[MAX_NAME];          // null terminated
+  uint64_t offset;              // from the start of the file
+  uint32_t count;
+  uint32_t unused;
+};
+
+typedef std::vector<std::pair<std::string, std::vector<double> > > TableList;
+
+uint32_t crc32(const void* data, size_t size);
+
+// Write the tables to fileName.  The file is written under a temporary name
+// and then renamed, so that a reader never sees it half written.
+bool write(const std::string& fileName, const TableList& tables, std::string* error);
+
+class File {
+  public:
+    File();
+    ~File();
+
+    // Map the file and check its header and checksum.  On failure the
+    // reason is put in error.
+    bool open(const std::string& fileName, std::string* error);
+
+    size_t nTables() const { return header_ ? header_->nTables : 0; }
+    const TableEntry& entry(size_t i) const { return entries_[i]; }
+
+    // The values of a table, or NULL if the file has no such table.
+    const double* table(const std::string& name, size_t* size) const;
+    // Replace values with a copy of a table.  False if there is none.
+    bool get(const std::string& name, std::vector<double>* values) const;
+
+    const std::string& fileName() const { return fileName_; }
+    uint32_t checksum() const { return header_ ? header_->checksum : 0; }
+
+    // Identity of the file on disk when it was opened.
+    dev_t device() const { return device_; }
+    ino_t inode() const { return inode_; }
+    off_t size() const { return size_; }
+    time_t mtime() const { return mtime_; }
+    long mtimeNsec() const { return mtimeNsec_; }
+
+  private:
+    File(const File&);
+    File& operator=(const File&);
+
+    std::string fileName_;
+    void* map_;
+    size_t mapSize_;
+    const Header* header_;
+    const TableEntry* entries_;
+    dev_t device_;
+    ino_t inode_;
+    off_t size_;
+    time_t mtime_;
+    long mtimeNsec_;
+};
+
+// Reopens a calibration file when it changes on disk (a new inode, size or
+// modification time).  Not thread-safe: callers serialize update().
+class Watcher {
+  public:
+    explicit Watcher(const std::string& fileName);
+
+    // The file, if it was changed since the last accepted one or none has
+    // been accepted yet, otherwise NULL.  If it cannot be opened, error is
+    // set and NULL returned.  Until it is passed to accept(), the next call
+    // opens it again, so that a file which the caller rejects is retried.
+    std::shared_ptr<const File> update(std::string* error);
+    // Make file, as returned by update(), the current one.
+    void accept(const std::shared_ptr<const File>& file) { current_ = file; }
+
+    const std::string& fileName() const { return fileName_; }
+
+  private:
+    std::string fileName_;
+    std::shared_ptr<const File> current_;
+};
+
+} // namespace uctcalib
+
+#endif /* end of include guard: UCTCALIBRATIONFILE_W5RT8NJC */
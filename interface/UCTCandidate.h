@@ -22,6 +22,7 @@
 
 #include "L1Trigger/UCT2015/interface/UCTRegion.h"
 #include "L1Trigger/UCT2015/interface/RegionAlgos.h"
+#include "L1Trigger/UCT2015/interface/UCTAttributeKeys.h"
 
 class UCTCandidate : public reco::LeafCandidate {
   public:
@@ -46,6 +47,34 @@ class UCTCandidate : public reco::LeafCandidate {
     void setInt(const std::string& item, int value);
     void setString(const std::string& item, const std::string& value);
 
+    // Versions of the above taking an interned key.  These don't build a
+    // std::string or touch the maps.
+    float getFloat(uctkey::Key item) const;
+    int getInt(uctkey::Key item) const;
+    float getFloat(uctkey::Key item, float defaultVal) const;
+    int getInt(uctkey::Key item, int defaultVal) const;
+    void setFloat(uctkey::Key item, float value);
+    void setInt(uctkey::Key item, int value);
+
+    // Region position, rank and isolation of the trigger object.  These are
+    // read by every consumer of the UCT output, so they are stored as plain
+    // members rather than attributes; getInt/setInt with their names (or
+    // keys) still work and read/write the same members.
+    int rgnEta() const { return rgnEta_; }
+    int rgnPhi() const { return rgnPhi_; }
+    int rctEta() const { return rctEta_; }
+    int rctPhi() const { return rctPhi_; }
+    int rank() const { return rank_; }
+    bool isIsolated() const { return isIsolated_; }
+    void setRegion(int rgnEta, int rgnPhi, int rctEta, int rctPhi);
+    void setRgnPhi(int rgnPhi);
+    void setRank(int rank);
+    void setIsolated(bool isolated);
+
+    // Move any interned attributes found in the string maps (e.g. read from
+    // files written before the inline storage existed) into inline storage.
+    void internAttributes();
+
     // Sort by ascending PT per default.
     bool operator < (const UCTCandidate& other) const;
 
@@ -61,7 +90,35 @@ class UCTCandidate : public reco::LeafCandidate {
     friend std::ostream& operator<<(std::ostream &os, const UCTCandidate& t);
 
   private:
-    // data storage
+    static bool isTypedField(uctkey::Key item);
+
+    static const unsigned int MAX_INLINE_INTS = 16;
+    static const unsigned int MAX_INLINE_FLOATS = 8;
+
+    const int* findInt(uctkey::Key item) const;
+    const float* findFloat(uctkey::Key item) const;
+
+    // Typed fields, see above.  Bit <key> of typedFieldsSet_ records which
+    // have been set, so that getInt keeps throwing for unset ones.
+    int rgnEta_;
+    int rgnPhi_;
+    int rctEta_;
+    int rctPhi_;
+    int rank_;
+    bool isIsolated_;
+    unsigned char typedFieldsSet_;
+
+    // Interned attributes, stored as (key, value) pairs in small inline
+    // arrays.  Only the first nInts_/nFloats_ entries are used.
+    unsigned char nInts_;
+    unsigned char nFloats_;
+    unsigned char intKeys_[MAX_INLINE_INTS];
+    int intValues_[MAX_INLINE_INTS];
+    unsigned char floatKeys_[MAX_INLINE_FLOATS];
+    float floatValues_[MAX_INLINE_FLOATS];
+
+    // data storage for attributes which aren't interned, or which don't fit
+    // in the inline arrays.
     std::map<std::string, float> floatData_;
     std::map<std::string, int> intData_;
     std::map<std::string, std::string> stringData_;
@@ -0,0 +1,63 @@
+#ifndef UCTCANDIDATETABLE_H7KX2MQE
+#define UCTCANDIDATETABLE_H7KX2MQE
+
+/*
+ * =====================================================================================
+ *
+ *       Filename:  UCTCandidateTable.h
+ *
+ *    Description:  Column-wise (structure of arrays) copy of a collection of
+ *                  UCTCandidates, with one fixed-type column per quantity.
+ *                  Much cheaper to write and read back than the full
+ *                  candidates, and the columns can be looped over directly.
+ *
+ * =====================================================================================
+ */
+
+#include <cstddef>
+#include <vector>
+
+class UCTCandidate;
+
+class UCTCandidateTable {
+  public:
+    // Bits of the flags column.  Stored in files, so only append.
+    enum Flag {
+      kIsolated = 0,
+      kIsEle,
+      kIsHighPtEle,
+      kEllIsolation,
+      kTauVeto,
+      kMipBit
+    };
+
+    UCTCandidateTable();
+    explicit UCTCandidateTable(const std::vector<UCTCandidate>& cands);
+
+    void reserve(size_t n);
+    void push_back(const UCTCandidate& cand);
+
+    size_t size() const { return pt_.size(); }
+
+    const std::vector<float>& pt() const { return pt_; }
+    const std::vector<float>& eta() const { return eta_; }
+    const std::vector<float>& phi() const { return phi_; }
+    const std::vector<int>& rank() const { return rank_; }
+    const std::vector<short>& rgnEta() const { return rgnEta_; }
+    const std::vector<short>& rgnPhi() const { return rgnPhi_; }
+    const std::vector<unsigned int>& flags() const { return flags_; }
+
+    // Whether flag f is set for the i-th candidate.
+    bool flag(size_t i, Flag f) const { return (flags_[i] >> f) & 1; }
+
+  private:
+    std::vector<float> pt_;
+    std::vector<float> eta_;
+    std::vector<float> phi_;
+    std::vector<int> rank_;
+    std::vector<short> rgnEta_;
+    std::vector<short> rgnPhi_;
+    std::vector<unsigned int> flags_;
+};
+
+#endif /* end of include guard: UCTCANDIDATETABLE_H7KX2MQE */
@@ -0,0 +1,262 @@
+#ifndef UCTCORE_R4TZ8NVC
+#define UCTCORE_R4TZ8NVC
+
+/*
+ * =====================================================================================
+ *
+ *       Filename:  UCTCore.h
+ *
+ *    Description:  The UCT2015 emulation as plain functions of plain data:
+ *                  PU estimation, region correction, energy sums, jets,
+ *                  EG/tau finding and the translation to GCT hardware
+ *                  quantities.  Nothing here depends on the framework or on
+ *                  ROOT; UCT2015Producer, RegionCorrection and
+ *                  UCT2015GctCandsProducer only convert their inputs and
+ *                  outputs (see UCTCoreAdapters.h).
+ *
+ * =====================================================================================
+ */
+
+#include <algorithm>
+#include <iosfwd>
+#include <memory>
+#include <vector>
+#include <stdint.h>
+
+#include "L1Trigger/UCT2015/interface/UCTCoreTypes.h"
+#include "L1Trigger/UCT2015/interface/UCTArena.h"
+#include "L1Trigger/UCT2015/interface/UCTRegionGrid.h"
+#include "L1Trigger/UCT2015/interface/UCTAnnulusCache.h"
+#include "L1Trigger/UCT2015/interface/UCTSummedAreaTable.h"
+#include "L1Trigger/UCT2015/interface/UCTJetFinderKernel.h"
+
+class UCTRegionCorrectionTable;
+
+namespace uctcore {
+
+// The UCT2015Producer parameters used by the emulation.
+struct Config {
+  Config();
+
+  // Fill the fixed-point versions of regionLSB and jetSF.  Must be called
+  // after changing either.
+  void deriveConstants();
+
+  bool puCorrectHI;
+  bool applyJetCalibration;
+  bool useHI;
+  // Integer (UCTFixedPoint.h) arithmetic for the PU levels, the MET/MHT/
+  // SET/SHT sums with their region ET cuts, and the jetSF calibration.
+  // Region correction, jet finding and the EG/tau isolation are not
+  // affected.
+  bool useFixedPointSumsAndJetSF;
+
+  unsigned int puETMax;
+  unsigned int regionETCutForHT;
+  unsigned int regionETCutForNeighbor;
+  unsigned int regionETCutForMET;
+  unsigned int minGctEtaForSums;
+  unsigned int maxGctEtaForSums;
+  unsigned int jetSeed;
+  unsigned int egtSeed;
+  unsigned int tauSeed;
+
+  double relativeTauIsolationCut;
+  double relativeJetIsolationCut;
+  double switchOffTauIso;
+
+  double egLSB;
+  double regionLSB;
+  std::vector<double> jetSF;
+
+  // If set, the input regions are the uncorrected ones and the PUM0
+  // correction is done by the correctRegions() stage, as RegionCorrection
+  // would; otherwise the regions come corrected.
+  std::shared_ptr<const UCTRegionCorrectionTable> regionCorrection;
+
+  int64_t regionLSBQ16;
+  std::vector<int64_t> jetSFQ16;
+};
+
+typedef std::vector<Candidate, UCTArenaAllocator<Candidate> > CandidateVector;
+
+// A collection which is filled during the event and then converted into the
+// event product.  The storage comes from the per-event arena if that is
+// enabled, otherwise from the heap and is kept from one event to the next.  Remembers the
+// largest size seen, so that the storage can be reserved in one go.
+struct CandidateBuffer : public CandidateVector {
+  explicit CandidateBuffer(UCTArena* arena) :
+    CandidateVector(UCTArenaAllocator<Candidate>(arena)), highWater(0) {}
+  // Empty the collection, keeping room for highWater candidates.
+  void reset() {
+    clear();
+    reserve(highWater);
+  }
+  // Empty the collection at the end of the event.
+  void discard() {
+    highWater = std::max(highWater, size());
+    if(get_allocator().arena()->enabled()) {
+      // The arena is about to be reset, so drop the storage.
+      CandidateVector(get_allocator()).swap(*this);
+    } else {
+      clear();
+    }
+  }
+  size_t highWater;
+};
+
+// All the state of the emulation for one event: the inputs, the
+// intermediate results shared between the stages, and the outputs.  Meant
+// to be reused from one event to the next.
+struct EventState {
+  explicit EventState(bool useEventArena = false);
+
+  // Inputs, filled by the caller.  puLevelPUM0 is the PUM0 bin from the
+  // region correction, or -1; if Config::regionCorrection is set it is
+  // filled by correctRegions(), which also corrects the regions in place.
+  std::vector<Region> regions;
+  std::vector<EmCand> emCands;
+  unsigned int puLevelPUM0;
+  // The corrected ET of each region, before it is fitted into the data word
+  // (see correctedRegion()); filled by correctRegions().
+  std::vector<unsigned int> regionEtCorr;
+
+  unsigned int puLevelHI;
+  // puLevelHI divided by puCount*Area, not multiply by 9.0
+  unsigned int puLevelHIUIC;
+  int puLevelHIHI[uctgrid::N_ETA];
+
+  unsigned int sumET;
+  int sumEx;
+  int sumEy;
+  unsigned int MET;
+
+  unsigned int sumHT;
+  int sumHx;
+  int sumHy;
+  unsigned int MHT;
+
+  Candidate METObject;
+  Candidate MHTObject;
+  Candidate SETObject;
+  Candidate SHTObject;
+
+  // Per-event storage for the candidate collections below, if useEventArena
+  // is set.  Declared before them, so that it outlives them.
+  UCTArena eventArena;
+
+  CandidateBuffer jetList, corrJetList;
+  CandidateBuffer rlxTauList, corrRlxTauList;
+  CandidateBuffer rlxEGList;
+  CandidateBuffer isoTauList, corrIsoTauList;
+  CandidateBuffer isoEGList;
+  CandidateBuffer rlxTauRegionOnlyList, isoTauRegionOnlyList;
+
+  // Dense [gctEta][gctPhi] view of regions, rebuilt every event.
+  UCTRegionGrid regionGrid;
+  // Annulus observables around every cell, shared by makeEGTaus() and
+  // makeTaus().
+  UCTAnnulusCache annulusCache;
+  // Region ET seen by the jet finder (HI-subtracted if requested) and its
+  // integral, filled by makeJets().
+  double jetRegionEt[uctgrid::N_CELLS];
+  UCTSummedAreaTable jetEtSums;
+  UCTJetSeeds jetSeeds;
+  // Position in jetList of the first jet centred on each cell, or -1.
+  int jetIndex[uctgrid::N_CELLS];
+};
+
+// The emulation stages.  Each reads the inputs and the results of the
+// stages it depends on from the state, and writes its own results there.
+
+// regions (corrected in place) and puLevelPUM0, if regionCorrection is
+// set; otherwise nothing.
+void correctRegions(const Config& config, EventState& state);
+// puLevelHI, puLevelHIUIC, puLevelHIHI (if puCorrectHI).
+void estimatePU(const Config& config, EventState& state);
+// regionGrid, annulusCache.
+void buildGrid(const Config& config, EventState& state);
+// MET/MHT/SET/SHT objects; needs estimatePU and buildGrid.
+void makeSums(const Config& config, EventState& state);
+// jetList, jetEtSums, jetIndex; needs estimatePU and buildGrid.
+void makeJets(const Config& config, EventState& state);
+// corrJetList; needs makeJets.
+void calibrateJets(const Config& config, EventState& state);
+// rlx/iso EG and ECAL seeded tau lists; needs estimatePU, buildGrid and
+// makeJets.
+void makeEGTaus(const Config& config, EventState& state);
+// rlx/iso region seeded tau lists; same inputs as makeEGTaus.
+void makeTaus(const Config& config, EventState& state);
+
+// Run all of the above in order.
+void emulate(const Config& config, EventState& state);
+
+// Sort candidates by descending pt, in place.  Candidates with equal pt end
+// up in the reverse of the order they were added in.
+void sortDescending(CandidateVector& cands);
+
+// Region correction (PUM0 subtraction and calibration).
+
+// Number of regions with non-zero ET.
+unsigned int puMultiplicity(const std::vector<Region>& regions);
+
+// A region with its ET replaced by the corrected one, as UCT2015Producer
+// reads it back from the CorrectedRegions of RegionCorrection: the ET keeps
+// only the bits of the data word (8 in HF), setting the overflow bit if it
+// does not fit, and HF regions lose their MIP and quiet bits.
+Region correctedRegion(const Region& region, unsigned int et);
+
+// The ECAL 2x1 ET of every region position: the rank of the first EM
+// candidate there, which is not calibrated.  The candidates are set last to
+// first, so that the first one at a position is kept; the cost is linear in
+// regions plus candidates.
+class Ecal2x1Grid {
+  public:
+    Ecal2x1Grid() { clear(); }
+    void clear();
+    // Clear, then set all of emCands (in reverse order).
+    void fill(const std::vector<EmCand>& emCands);
+    void set(unsigned int gctEta, unsigned int gctPhi, unsigned int rank);
+    unsigned int at(unsigned int gctEta, unsigned int gctPhi) const;
+
+  private:
+    unsigned int rank_[uctgrid::N_CELLS];
+    // Candidates at positions off the grid (only seen in corrupt data, kept
+    // so that such regions are corrected as before), in the order set.
+    std::vector<EmCand> offGrid_;
+};
+
+// Corrected ET of a region with the given position, ET and ECAL 2x1 ET;
+// only non-empty regions are corrected.  If debug is given, a line for a
+// corrected region is written to it.
+unsigned int correctedEt(const UCTRegionCorrectionTable& table, int pumBin,
+    unsigned int gctEta, unsigned int et, unsigned int energyECAL2x1,
+    std::ostream* debug = 0);
+
+// Copy of the regions with the corrected ET, in the same order.  If debug
+// is given, a line per corrected region is written to it.
+void correctRegions(const UCTRegionCorrectionTable& table,
+    const std::vector<Region>& regions, const std::vector<EmCand>& emCands,
+    int pumBin, std::vector<Region>* corrected, std::ostream* debug = 0);
+
+// Translation to GCT hardware quantities.
+
+// EG ET saturated at 63 GeV (if saturate is set), before the EM scale.
+double gctSaturatedEgEt(double pt, bool saturate);
+// GCT eta of an EG candidate: RCT eta in the low 3 bits, sign bit 3 set for
+// negative eta.
+unsigned int gctEmEta(unsigned int rgnEta, unsigned int rctEta);
+// GCT eta and phi of a jet or tau.
+unsigned int gctJetEta(unsigned int rgnEta, unsigned int rctEta);
+unsigned int gctJetPhi(unsigned int rgnPhi);
+// Whether a jet goes to the forward jet collection.
+bool gctIsForwardJet(unsigned int rctEta);
+// Rank of a scalar sum with the given LSB.
+unsigned int gctSumRank(double pt, double lsb);
+// Phi bins of MET (72) and MHT (18) for a phi in [-pi, pi].
+unsigned int gctMETPhi(double phi);
+unsigned int gctMHTPhi(double phi);
+
+} // namespace uctcore
+
+#endif /* end of include guard: UCTCORE_R4TZ8NVC */
@@ -0,0 +1,60 @@
+#ifndef UCTCOREADAPTERS_J6FN3PWE
+#define UCTCOREADAPTERS_J6FN3PWE
+
+/*
+ * =====================================================================================
+ *
+ *       Filename:  UCTCoreAdapters.h
+ *
+ *    Description:  Conversions between the framework data formats and the
+ *                  plain types of the emulation core (UCTCoreTypes.h).
+ *
+ * =====================================================================================
+ */
+
+#include <vector>
+
+#include "L1Trigger/UCT2015/interface/UCTCoreTypes.h"
+
+class L1CaloRegion;
+class L1CaloEmCand;
+class UCTCandidate;
+
+namespace uctfile {
+struct RegionWord;
+struct EmCandWord;
+}
+
+namespace uctcore {
+
+Region makeRegion(const L1CaloRegion& region);
+EmCand makeEmCand(const L1CaloEmCand& cand);
+
+// Replace the contents of out with the converted collection.
+void makeRegions(const std::vector<L1CaloRegion>& regions,
+    std::vector<Region>* out);
+void makeEmCands(const std::vector<L1CaloEmCand>& cands,
+    std::vector<EmCand>* out);
+
+// A copy of a region with the ET replaced by the corrected one, as put in
+// the CorrectedRegions collection.
+L1CaloRegion makeCorrectedL1CaloRegion(const L1CaloRegion& region, unsigned int et);
+
+// The other way, for inputs made outside the framework (see
+// test/UCTEventGenerator.h).  The hardware position is derived from the GCT one.
+L1CaloRegion makeL1CaloRegion(const Region& region);
+L1CaloEmCand makeL1CaloEmCand(const EmCand& cand);
+
+// The data words kept in UCTEventFile records, and back.
+uctfile::RegionWord makeRegionWord(const L1CaloRegion& region);
+uctfile::EmCandWord makeEmCandWord(const L1CaloEmCand& cand);
+L1CaloRegion makeL1CaloRegion(const uctfile::RegionWord& word);
+L1CaloEmCand makeL1CaloEmCand(const uctfile::EmCandWord& word);
+
+// Add a UCTCandidate with the attributes which are set in cand to out,
+// constructing it in place.
+void appendUCTCandidate(const Candidate& cand, std::vector<UCTCandidate>* out);
+
+} // namespace uctcore
+
+#endif /* end of include guard: UCTCOREADAPTERS_J6FN3PWE */
@@ -0,0 +1,100 @@
+#ifndef UCTCORETYPES_M2WQ7HXB
+#define UCTCORETYPES_M2WQ7HXB
+
+/*
+ * =====================================================================================
+ *
+ *       Filename:  UCTCoreTypes.h
+ *
+ *    Description:  Plain input and output types of the UCT emulation core:
+ *                  calorimeter regions and EM candidates as they come from
+ *                  the RCT, and the trigger candidates built from them.
+ *                  Only the standard library is used, so the core can run
+ *                  outside the framework (see UCTCore.h).
+ *
+ * =====================================================================================
+ */
+
+#include <stdint.h>
+#include "L1Trigger/UCT2015/interface/UCTAttributeKeys.h"
+
+namespace uctcore {
+
+// An RCT region, i.e. the fields of L1CaloRegion used by the emulation.
+struct Region {
+  unsigned int et;
+  unsigned int gctEta;
+  unsigned int gctPhi;
+  unsigned int rctEta;
+  unsigned int rctPhi;
+  bool overFlow;
+  bool tauVeto;
+  bool mip;
+  bool quiet;
+  bool fineGrain;
+};
+
+// An RCT EM candidate, positioned by the region it sits in.
+struct EmCand {
+  unsigned int rank;
+  unsigned int gctEta;
+  unsigned int gctPhi;
+  unsigned int rctEta;
+  unsigned int rctPhi;
+  bool isolated;
+};
+
+// A trigger candidate with the interned attributes of UCTCandidate.  Every
+// attribute, including the typed fields, has a fixed slot; a bit mask
+// records which have been set, so that the conversion to UCTCandidate only
+// carries those.
+class Candidate {
+  public:
+    Candidate();
+    Candidate(double pt, double eta, double phi);
+
+    double pt() const { return pt_; }
+    double eta() const { return eta_; }
+    double phi() const { return phi_; }
+
+    int rgnEta() const { return ints_[uctkey::rgnEta]; }
+    int rgnPhi() const { return ints_[uctkey::rgnPhi]; }
+    int rctEta() const { return ints_[uctkey::rctEta]; }
+    int rctPhi() const { return ints_[uctkey::rctPhi]; }
+    int rank() const { return ints_[uctkey::rank]; }
+    bool isIsolated() const { return ints_[uctkey::isIsolated]; }
+    void setRegion(int rgnEta, int rgnPhi, int rctEta, int rctPhi);
+    void setRgnPhi(int rgnPhi) { setInt(uctkey::rgnPhi, rgnPhi); }
+    void setRank(int rank) { setInt(uctkey::rank, rank); }
+    void setIsolated(bool isolated) { setInt(uctkey::isIsolated, isolated); }
+
+    // Unset attributes read as 0.
+    int getInt(uctkey::Key item) const { return ints_[item]; }
+    float getFloat(uctkey::Key item) const { return floats_[item]; }
+    bool hasInt(uctkey::Key item) const { return (intsSet_ >> item) & 1; }
+    bool hasFloat(uctkey::Key item) const { return (floatsSet_ >> item) & 1; }
+    void setInt(uctkey::Key item, int value) {
+      ints_[item] = value;
+      intsSet_ |= uint64_t(1) << item;
+    }
+    void setFloat(uctkey::Key item, float value) {
+      floats_[item] = value;
+      floatsSet_ |= uint64_t(1) << item;
+    }
+
+    // Sort by ascending PT, like UCTCandidate.
+    bool operator < (const Candidate& other) const { return pt_ < other.pt_; }
+
+  private:
+    double pt_;
+    double eta_;
+    double phi_;
+    uint64_t intsSet_;
+    uint64_t floatsSet_;
+    int ints_[uctkey::N_KEYS];
+    float floats_[uctkey::N_KEYS];
+};
+
+} // namespace uctcore
+
+#endif /* end of include guard: UCTCORETYPES_M2WQ7HXB */
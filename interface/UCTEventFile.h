@@ -0,0 +1,159 @@
+#ifndef UCTEVENTFILE_Q8HZ3MVD
+#define UCTEVENTFILE_Q8HZ3MVD
+
+/*
+ * =====================================================================================
+ *
+ *       Filename:  UCTEventFile.h
+ *
+ *    Description:  Flat binary file of the RCT regions and EM candidates of
+ *                  each event, to replay the emulation without the RAW
+ *                  unpacking, the RCT emulator and EDM I/O.
+ *
+ *                  The file is a Header followed by fixed size Records, one
+ *                  per event, in host byte order.  A record keeps the
+ *                  L1CaloRegion and L1CaloEmCand data words as they are,
+ *                  with the GCT position of each, in the order of the
+ *                  collections (the emulation output depends on it).  The
+ *                  reader maps the file, so that record(i) is a pointer
+ *                  into it.
+ *
+ *                  Only the standard library and POSIX are used; see
+ *                  UCTCoreAdapters.h for the framework collections.
+ *
+ * =====================================================================================
+ */
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "L1Trigger/UCT2015/interface/UCTCoreTypes.h"
+
+namespace uctfile {
+
+const uint32_t VERSION = 1;
+
+// Every region once, and 4 isolated and 4 non-isolated candidates from
+// each of the 18 RCT crates.
+const unsigned int MAX_REGIONS = 396;
+const unsigned int MAX_EM_CANDS = 144;
+
+struct Header {
+  char magic[8];                // "UCTEVENT"
+  uint32_t version;
+  uint32_t recordSize;          // sizeof(Record)
+  uint16_t maxRegions;
+  uint16_t maxEmCands;
+  uint32_t unused[3];
+};
+
+// L1CaloRegion::raw(): ET in bits 0-9 (0-7 in HF), then the overflow, tau
+// veto (fine grain in HF), MIP and quiet bits.
+struct RegionWord {
+  uint16_t raw;
+  uint8_t gctEta;
+  uint8_t gctPhi;
+};
+
+// L1CaloEmCand::raw(): rank in bits 0-5, then the RCT region (1 bit) and
+// card (3 bits).  The crate, isolation and index are not in the word.
+struct EmCandWord {
+  uint16_t raw;
+  uint8_t gctEta;
+  uint8_t gctPhi;
+  uint8_t rctCrate;
+  uint8_t isolated;
+  uint16_t index;
+};
+
+struct Record {
+  uint32_t run;
+  uint32_t lumi;
+  uint64_t event;
+  uint16_t nRegions;
+  uint16_t nEmCands;
+  uint32_t unused;
+  RegionWord regions[MAX_REGIONS];
+  EmCandWord emCands[MAX_EM_CANDS];
+};
+
+// Decoding of the data words into the core types.
+uctcore::Region makeRegion(const RegionWord& word);
+uctcore::EmCand makeEmCand(const EmCandWord& word);
+
+// Check that the counts of a record fit in it and that every region and EM
+// candidate is on the 22x18 grid.  On failure the reason is put in error.
+bool check(const Record& record, std::string* error);
+
+// Replace the contents of regions and emCands with those of the record,
+// which must pass check() (all the records of a Reader do).
+void unpack(const Record& record, std::vector<uctcore::Region>* regions,
+    std::vector<uctcore::EmCand>* emCands);
+
+class Writer {
+  public:
+    Writer();
+    ~Writer();
+
+    // Create (or truncate) the file and write the header.  On failure the
+    // reason is put in error.
+    bool open(const std::string& fileName, std::string* error);
+    // Append a record, which must pass check().  Unused region and EM
+    // candidate slots are written as zeros.
+    bool write(const Record& record, std::string* error);
+    bool close(std::string* error);
+
+    unsigned long nRecords() const { return nRecords_; }
+
+  private:
+    Writer(const Writer&);
+    Writer& operator=(const Writer&);
+
+    std::FILE* file_;
+    std::string fileName_;
+    unsigned long nRecords_;
+};
+
+class Reader {
+  public:
+    Reader();
+    ~Reader();
+
+    // Map the file read-only, after checking the header and every record
+    // (see check()), and index the records by event.  On failure the
+    // reason is put in error.
+    bool open(const std::string& fileName, std::string* error);
+    void close();
+
+    size_t size() const { return nRecords_; }
+    const Record& record(size_t i) const { return records_[i]; }
+
+    // The index of the record of an event, or size() if the file has none.
+    // If an event was recorded more than once, the first record is found.
+    size_t find(uint32_t run, uint32_t lumi, uint64_t event) const;
+
+  private:
+    Reader(const Reader&);
+    Reader& operator=(const Reader&);
+
+    struct EventIndex {
+      uint32_t run;
+      uint32_t lumi;
+      uint64_t event;
+      size_t record;
+      bool operator<(const EventIndex& other) const;
+    };
+
+    void* map_;
+    size_t mapSize_;
+    const Record* records_;
+    size_t nRecords_;
+    // Sorted by event, then record.
+    std::vector<EventIndex> index_;
+};
+
+} // namespace uctfile
+
+#endif /* end of include guard: UCTEVENTFILE_Q8HZ3MVD */
@@ -0,0 +1,110 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  UCTFixedPoint.h
+ *
+ *    Description:  Integer arithmetic for the fixed-point mode of the UCT
+ *                  emulation (useFixedPointSumsAndJetSF: PU levels, sums
+ *                  and jet calibration).  Physical quantities are carried as Q16 values
+ *                  (GeV * 2^16) in 64 bit integers, and every conversion back to
+ *                  an integer rank has a defined rounding, so results do not
+ *                  depend on the compiler or the FPU.
+ *
+ * =====================================================================================
+ */
+
+#ifndef UCTFIXEDPOINT_T4NB8WZE
+#define UCTFIXEDPOINT_T4NB8WZE
+
+#include <stdint.h>
+#include "L1Trigger/UCT2015/interface/helpers.h"
+
+namespace uctfixed {
+
+const int FRAC_BITS = 16;
+const int64_t ONE = int64_t(1) << FRAC_BITS;
+
+// Convert a configuration constant to Q16, rounding to nearest.  Only used
+// when a module is configured, never on per-event data.
+constexpr int64_t toQ16(double x) {
+  return int64_t(x * ONE + (x < 0 ? -0.5 : 0.5));
+}
+
+// Integer part of a Q16 value, rounding toward zero (like a C cast of the
+// equivalent double).
+inline int64_t truncQ16(int64_t x) {
+  return x < 0 ? -((-x) >> FRAC_BITS) : x >> FRAC_BITS;
+}
+
+// Integer part of a Q(2*FRAC_BITS) value (the product of two Q16 values),
+// rounding toward zero.
+inline int64_t truncQ32(int64_t x) {
+  return x < 0 ? -((-x) >> (2 * FRAC_BITS)) : x >> (2 * FRAC_BITS);
+}
+
+// Nearest integer to num/den for num >= 0, den > 0, halves rounded up (like
+// floor(x + 0.5)).
+inline int64_t divRound(int64_t num, int64_t den) {
+  return (2 * num + den) / (2 * den);
+}
+
+// floor(sqrt(x))
+inline uint64_t isqrt(uint64_t x) {
+  uint64_t result = 0;
+  uint64_t bit = uint64_t(1) << 62;
+  while (bit > x)
+    bit >>= 2;
+  while (bit != 0) {
+    if (x >= result + bit) {
+      x -= result + bit;
+      result = (result >> 1) + bit;
+    } else {
+      result >>= 1;
+    }
+    bit >>= 2;
+  }
+  return result;
+}
+
+// Q16 versions of the uctgeo tables.
+constexpr int64_t cosRegionPhi[uctgeo::N_RGN_PHI] = {
+  toQ16(uctgeo::cosRegionPhi[0]), toQ16(uctgeo::cosRegionPhi[1]),
+  toQ16(uctgeo::cosRegionPhi[2]), toQ16(uctgeo::cosRegionPhi[3]),
+  toQ16(uctgeo::cosRegionPhi[4]), toQ16(uctgeo::cosRegionPhi[5]),
+  toQ16(uctgeo::cosRegionPhi[6]), toQ16(uctgeo::cosRegionPhi[7]),
+  toQ16(uctgeo::cosRegionPhi[8]), toQ16(uctgeo::cosRegionPhi[9]),
+  toQ16(uctgeo::cosRegionPhi[10]), toQ16(uctgeo::cosRegionPhi[11]),
+  toQ16(uctgeo::cosRegionPhi[12]), toQ16(uctgeo::cosRegionPhi[13]),
+  toQ16(uctgeo::cosRegionPhi[14]), toQ16(uctgeo::cosRegionPhi[15]),
+  toQ16(uctgeo::cosRegionPhi[16]), toQ16(uctgeo::cosRegionPhi[17])
+};
+
+constexpr int64_t sinRegionPhi[uctgeo::N_RGN_PHI] = {
+  toQ16(uctgeo::sinRegionPhi[0]), toQ16(uctgeo::sinRegionPhi[1]),
+  toQ16(uctgeo::sinRegionPhi[2]), toQ16(uctgeo::sinRegionPhi[3]),
+  toQ16(uctgeo::sinRegionPhi[4]), toQ16(uctgeo::sinRegionPhi[5]),
+  toQ16(uctgeo::sinRegionPhi[6]), toQ16(uctgeo::sinRegionPhi[7]),
+  toQ16(uctgeo::sinRegionPhi[8]), toQ16(uctgeo::sinRegionPhi[9]),
+  toQ16(uctgeo::sinRegionPhi[10]), toQ16(uctgeo::sinRegionPhi[11]),
+  toQ16(uctgeo::sinRegionPhi[12]), toQ16(uctgeo::sinRegionPhi[13]),
+  toQ16(uctgeo::sinRegionPhi[14]), toQ16(uctgeo::sinRegionPhi[15]),
+  toQ16(uctgeo::sinRegionPhi[16]), toQ16(uctgeo::sinRegionPhi[17])
+};
+
+constexpr int64_t regionArea[uctgeo::N_RGN_ETA] = {
+  toQ16(uctgeo::regionArea[0]), toQ16(uctgeo::regionArea[1]),
+  toQ16(uctgeo::regionArea[2]), toQ16(uctgeo::regionArea[3]),
+  toQ16(uctgeo::regionArea[4]), toQ16(uctgeo::regionArea[5]),
+  toQ16(uctgeo::regionArea[6]), toQ16(uctgeo::regionArea[7]),
+  toQ16(uctgeo::regionArea[8]), toQ16(uctgeo::regionArea[9]),
+  toQ16(uctgeo::regionArea[10]), toQ16(uctgeo::regionArea[11]),
+  toQ16(uctgeo::regionArea[12]), toQ16(uctgeo::regionArea[13]),
+  toQ16(uctgeo::regionArea[14]), toQ16(uctgeo::regionArea[15]),
+  toQ16(uctgeo::regionArea[16]), toQ16(uctgeo::regionArea[17]),
+  toQ16(uctgeo::regionArea[18]), toQ16(uctgeo::regionArea[19]),
+  toQ16(uctgeo::regionArea[20]), toQ16(uctgeo::regionArea[21])
+};
+
+} // namespace uctfixed
+
+#endif /* end of include guard: UCTFIXEDPOINT_T4NB8WZE */
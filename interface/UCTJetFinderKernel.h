@@ -0,0 +1,46 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  UCTJetFinderKernel.h
+ *
+ *    Description:  Vectorized local-maximum jet finder over the region grid.
+ *
+ * =====================================================================================
+ */
+
+#ifndef UCTJETFINDERKERNEL_P2VD8KQA
+#define UCTJETFINDERKERNEL_P2VD8KQA
+
+#include "L1Trigger/UCT2015/interface/UCTRegionGrid.h"
+
+struct UCTJetSeeds {
+  // Bit gctPhi of rowMask[gctEta] is set if that region seeds a jet.
+  unsigned int rowMask[uctgrid::N_ETA];
+  // Sum of the 3x3 window around every cell, missing neighbors counting 0.
+  double sum3x3[uctgrid::N_CELLS];
+
+  bool isSeed(int gctEta, int gctPhi) const {
+    return (rowMask[gctEta] >> gctPhi) & 1;
+  }
+};
+
+// Run the jet seed test on every cell of "et" (uctgrid::N_CELLS values,
+// indexed by uctgrid::index).  A cell is a seed if its ET is above
+// seedThreshold and it is a local maximum, with the tie-breaking used by the
+// UCT jet finder:
+//
+//    >=NE  >=E  >=SE
+//     >N    .   >=S
+//     >NW  >W   >SW
+//
+// i.e. strictly greater than the N, NW, W and SW neighbors and greater or equal
+// to the NE, E, SE and S ones.  Off the eta edges neighbors count as 0.
+//
+// Each eta row is processed one phi vector at a time with AVX or SSE2 when the
+// compiler targets them; the results are bit-identical to the scalar version.
+void findJetSeeds(const double* et, double seedThreshold, UCTJetSeeds* out);
+
+// Plain C++ version of findJetSeeds, always available for cross-checks.
+void findJetSeedsScalar(const double* et, double seedThreshold, UCTJetSeeds* out);
+
+#endif /* end of include guard: UCTJETFINDERKERNEL_P2VD8KQA */
@@ -0,0 +1,97 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  UCTRegionCorrectionTable.h
+ *
+ *    Description:  The region calibration (regionSF) and PUM0 subtraction
+ *                  (regionSubtraction) constants, expanded once per
+ *                  configuration into one read-only entry per (gctEta, PUM0
+ *                  bin), in region ET units, and the whole correction
+ *                  tabulated as corrected ET per (gctEta, PUM0 bin, raw
+ *                  ET), as the firmware would do it.  Shared by all the
+ *                  events being processed.
+ *
+ * =====================================================================================
+ */
+
+#ifndef UCTREGIONCORRECTIONTABLE_P6TQ9LZC
+#define UCTREGIONCORRECTIONTABLE_P6TQ9LZC
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+class UCTRegionCorrectionTable {
+  public:
+    static const int N_ETA = 22;
+    // 396 regions in bins of 22.  A fully occupied event lands in bin 18.
+    static const int N_PUM_BINS = 19;
+    // Regions below this (in region ET units) are not calibrated.
+    static const unsigned int MIN_CALIBRATED_ET = 20;
+    // Raw region ET is 10 bits.
+    static const unsigned int N_ET = 1024;
+
+    struct Entry {
+      // PU subtraction, scale factor and offset, in region ET units.
+      double puSub;
+      double alpha;
+      double gamma;
+      // For a region which is not calibrated, ECAL 2x1 ET above the
+      // tabulated corrected ET adds ecalStep (0 or 1) to it.  -1 if that
+      // depends on the raw ET, in which case it is computed.
+      int ecalStep;
+    };
+
+    // No correction.  The lookup tables are only filled by build(), until
+    // then corrected() computes every region.
+    UCTRegionCorrectionTable();
+
+    // regionSF holds (scale, offset) pairs per gctEta, regionSubtraction 18
+    // PUM0 bins per gctEta, both in physical ET.  The switches are folded
+    // in: without calibration alpha=1 and gamma=0, without PU correction
+    // puSub=0.  Fills the lookup tables.  False, with the reason in error
+    // and the table unchanged, if a table which is used is too short for
+    // the N_ETA rings.
+    bool build(const std::vector<double>& regionSF,
+        const std::vector<double>& regionSubtraction,
+        bool applyCalibration, bool puMultCorrect, std::string* error);
+
+    // PUM0 bin for the number of non-zero regions.
+    static int pumBin(unsigned int puMult) { return puMult / 22; }
+
+    const Entry& at(unsigned int gctEta, int pumBin) const {
+      return table_[gctEta][pumBin];
+    }
+
+    // Corrected ET of a region with raw ET et and ECAL 2x1 ET ecal, both
+    // in region ET units, from the lookup tables where possible.
+    int corrected(unsigned int gctEta, int pumBin, unsigned int et,
+        unsigned int ecal) const {
+      if (et < lutEt_) {
+        int corr = lut_[(gctEta*N_PUM_BINS + pumBin)*N_ET + et];
+        if (ecal == 0)
+          return corr;
+        const Entry& entry = table_[gctEta][pumBin];
+        if (entry.ecalStep >= 0 &&
+            (et < MIN_CALIBRATED_ET || (entry.alpha == 1 && entry.gamma == 0)))
+          return corr > 0 && int(ecal) > corr ? corr + entry.ecalStep : corr;
+      }
+      return compute(gctEta, pumBin, et, ecal);
+    }
+
+    // The same, computed from the constants: PU subtraction, the ECAL
+    // energy taken out, calibration, the ECAL energy added back in.
+    int compute(unsigned int gctEta, int pumBin, unsigned int et,
+        unsigned int ecal) const;
+
+  private:
+    void fillLut();
+
+    Entry table_[N_ETA][N_PUM_BINS];
+    // Corrected ET without ECAL energy per (gctEta, PUM0 bin, raw ET), for
+    // raw ET below lutEt_ (N_ET once filled, 0 before).
+    std::vector<uint16_t> lut_;
+    unsigned int lutEt_;
+};
+
+#endif /* end of include guard: UCTREGIONCORRECTIONTABLE_P6TQ9LZC */
@@ -0,0 +1,132 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  UCTRegionGrid.h
+ *
+ *    Description:  Dense [gctEta][gctPhi] view of the calorimeter regions,
+ *                  filled once per event, with a compile-time table of the
+ *                  eight neighbors of every cell.
+ *
+ * =====================================================================================
+ */
+
+#ifndef UCTREGIONGRID_K3N8WQ2T
+#define UCTREGIONGRID_K3N8WQ2T
+
+#include <vector>
+
+namespace uctcore { struct Region; }
+
+namespace uctgrid {
+
+const int N_ETA = 22;
+const int N_PHI = 18;
+const int N_CELLS = N_ETA * N_PHI;
+
+// Neighbor directions, following the naming used by the jet finder:
+// N/S are -/+1 in gctPhi, E/W are +/-1 in gctEta.
+enum Direction { N, S, E, W, NE, SW, NW, SE, N_DIRECTIONS };
+
+struct NeighborRow {
+  short cell[N_DIRECTIONS];
+};
+
+struct NeighborTable {
+  NeighborRow row[N_CELLS];
+};
+
+namespace detail {
+
+constexpr int wrapPhi(int phi) {
+  return phi < 0 ? phi + N_PHI : (phi >= N_PHI ? phi - N_PHI : phi);
+}
+
+// Cell index of the region displaced by (dEta, dPhi), or -1 off the eta edge.
+// Phi wraps around.
+constexpr short offsetCell(int cell, int dEta, int dPhi) {
+  return (cell / N_PHI + dEta < 0 || cell / N_PHI + dEta >= N_ETA) ? short(-1) :
+    short((cell / N_PHI + dEta) * N_PHI + wrapPhi(cell % N_PHI + dPhi));
+}
+
+constexpr NeighborRow makeRow(int cell) {
+  return NeighborRow{{
+    offsetCell(cell,  0, -1),   // N
+    offsetCell(cell,  0, +1),   // S
+    offsetCell(cell, +1,  0),   // E
+    offsetCell(cell, -1,  0),   // W
+    offsetCell(cell, +1, -1),   // NE
+    offsetCell(cell, -1, +1),   // SW
+    offsetCell(cell, -1, -1),   // NW
+    offsetCell(cell, +1, +1)}}; // SE
+}
+
+// Compile-time integer sequence 0..N-1, built with logarithmic template
+// depth so the 396 rows don't hit the instantiation limit.
+template<int... I> struct Seq {};
+
+template<class A, class B> struct Concat;
+template<int... A, int... B> struct Concat<Seq<A...>, Seq<B...> > {
+  typedef Seq<A..., (int(sizeof...(A)) + B)...> type;
+};
+
+template<int N> struct MakeSeq {
+  typedef typename Concat<typename MakeSeq<N / 2>::type,
+          typename MakeSeq<N - N / 2>::type>::type type;
+};
+template<> struct MakeSeq<0> { typedef Seq<> type; };
+template<> struct MakeSeq<1> { typedef Seq<0> type; };
+
+template<int... I> constexpr NeighborTable makeTable(Seq<I...>) {
+  return NeighborTable{{ makeRow(I)... }};
+}
+
+} // namespace detail
+
+// neighbors.row[cell].cell[dir] is the cell index of the neighbor of "cell" in
+// direction "dir", or -1 if it falls off the eta edge.
+constexpr NeighborTable neighbors = detail::makeTable(detail::MakeSeq<N_CELLS>::type());
+
+inline int index(int gctEta, int gctPhi) {
+  return gctEta * N_PHI + gctPhi;
+}
+
+inline int neighborCell(int cell, int dir) {
+  return neighbors.row[cell].cell[dir];
+}
+
+// Position within the RCT card, as L1CaloRegionDetId::rctEta()/rctPhi().
+inline unsigned int rctEta(unsigned int gctEta) {
+  return gctEta < 11 ? 10 - gctEta : gctEta - 11;
+}
+
+inline unsigned int rctPhi(unsigned int gctPhi) {
+  return gctPhi % 2;
+}
+
+} // namespace uctgrid
+
+class UCTRegionGrid {
+  public:
+    UCTRegionGrid();
+
+    // Scatter the regions into the grid.  Physical ET is stored as
+    // max(0, regionLSB * et), the same as UCT2015Producer::regionPhysicalEt.
+    void fill(const std::vector<uctcore::Region>& regions, double regionLSB);
+
+    // The region at a given cell, or NULL if the event didn't have one.
+    const uctcore::Region* region(int cell) const { return region_[cell]; }
+    double et(int cell) const { return et_[cell]; }
+
+    // The neighbor of a cell in a given direction, or NULL if it is off the
+    // eta edge or missing from the event.
+    const uctcore::Region* neighbor(int cell, int dir) const {
+      int n = uctgrid::neighborCell(cell, dir);
+      return n < 0 ? 0 : region_[n];
+    }
+
+  private:
+    const uctcore::Region* region_[uctgrid::N_CELLS];
+    double et_[uctgrid::N_CELLS];
+};
+
+#endif /* end of include guard: UCTREGIONGRID_K3N8WQ2T */
@@ -0,0 +1,44 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  UCTSummedAreaTable.h
+ *
+ *    Description:  Summed-area table (integral image) over the region grid,
+ *                  with cylindrical wrap-around in phi.  Any rectangular
+ *                  window sum costs four reads, independent of its size.
+ *
+ * =====================================================================================
+ */
+
+#ifndef UCTSUMMEDAREATABLE_R7HZP4XM
+#define UCTSUMMEDAREATABLE_R7HZP4XM
+
+#include "L1Trigger/UCT2015/interface/UCTRegionGrid.h"
+
+class UCTSummedAreaTable {
+  public:
+    UCTSummedAreaTable();
+
+    // Build the table from uctgrid::N_CELLS values, indexed by
+    // uctgrid::index(gctEta, gctPhi).
+    void build(const double* values);
+
+    // Sum over gctEta in [etaLo, etaHi] (clipped to the detector) and nPhi
+    // consecutive phi bins starting at phiLo, wrapping around at phi = 18.
+    // phiLo may be negative; nPhi is clipped to a full turn.
+    double sum(int etaLo, int etaHi, int phiLo, int nPhi) const;
+
+    // Sum of the (2*radius+1) x (2*radius+1) window centred on a cell.
+    double window(int gctEta, int gctPhi, int radius) const {
+      return sum(gctEta - radius, gctEta + radius, gctPhi - radius, 2 * radius + 1);
+    }
+
+  private:
+    // Integral over eta rows [0, e) and phi columns [0, p) of the map with
+    // phi unrolled twice, so that any wrapped window is a plain rectangle.
+    static const int N_ROWS = uctgrid::N_ETA + 1;
+    static const int N_COLS = 2 * uctgrid::N_PHI + 1;
+    double table_[N_ROWS][N_COLS];
+};
+
+#endif /* end of include guard: UCTSUMMEDAREATABLE_R7HZP4XM */
@@ -14,6 +14,8 @@
 #ifndef HELPERS_W9QK6HND
 #define HELPERS_W9QK6HND
 
+#include <math.h>
+
 class L1CaloRegion;
 
 // Compute the difference in phi between two towers, wrapping at phi = N
@@ -24,21 +26,170 @@ int deltaGctPhi(const L1CaloRegion& r1, const L1CaloRegion& r2);
 // Calo detector mapping.
 //
 // See: https://twiki.cern.ch/twiki/bin/view/CMS/RCTMap
+//
+// The geometry only depends on small integer indices, so it is tabulated at
+// compile time.  The tables have internal linkage and are shared by every
+// module in the library.
+namespace uctgeo {
+
+const int N_RGN_ETA = 22;
+const int N_RGN_PHI = 18;
+const int N_TPG_ETA = 56;
+const int N_TPG_PHI = 72;
+
+// Physical eta at the center of each region.  0-10 are negative eta values,
+// 11-21 positive.  HB and inner HE bins are 0.348 wide, the last two HE bins
+// are 0.432 and 0.828 wide, and HF bins are 0.5 wide.
+constexpr double regionEta[N_RGN_ETA] = {
+  -4.750, -4.250, -3.750, -3.250, -2.586, -1.956,
+  -1.566, -1.218, -0.870, -0.522, -0.174, 0.174,
+  0.522, 0.870, 1.218, 1.566, 1.956, 2.586,
+  3.250, 3.750, 4.250, 4.750
+};
+
+// Physical phi at the center of each region.
+constexpr double regionPhi[N_RGN_PHI] = {
+  2. * M_PI * 0 / 18., 2. * M_PI * 1 / 18.,
+  2. * M_PI * 2 / 18., 2. * M_PI * 3 / 18.,
+  2. * M_PI * 4 / 18., 2. * M_PI * 5 / 18.,
+  2. * M_PI * 6 / 18., 2. * M_PI * 7 / 18.,
+  2. * M_PI * 8 / 18., 2. * M_PI * 9 / 18.,
+  -M_PI + 2. * M_PI * 1 / 18., -M_PI + 2. * M_PI * 2 / 18.,
+  -M_PI + 2. * M_PI * 3 / 18., -M_PI + 2. * M_PI * 4 / 18.,
+  -M_PI + 2. * M_PI * 5 / 18., -M_PI + 2. * M_PI * 6 / 18.,
+  -M_PI + 2. * M_PI * 7 / 18., -M_PI + 2. * M_PI * 8 / 18.
+};
+
+// Effective (eta x phi) area of a region in a given eta slice.
+constexpr double regionArea[N_RGN_ETA] = {
+  0.5*0.348, 0.5*0.348, 0.5*0.348, 0.5*0.348,
+  0.828*0.348, 0.432*0.348, 0.348*0.348, 0.348*0.348,
+  0.348*0.348, 0.348*0.348, 0.348*0.348, 0.348*0.348,
+  0.348*0.348, 0.348*0.348, 0.348*0.348, 0.348*0.348,
+  0.432*0.348, 0.828*0.348, 0.5*0.348, 0.5*0.348,
+  0.5*0.348, 0.5*0.348
+};
+
+// Physical eta of each TPG tower.  0-27 are negative eta values, 28-55 are
+// positive eta values.
+constexpr double tpgEta[N_TPG_ETA] = {
+  -2.825, -2.575,
+  -2.411, -2.247,
+  -2.1075, -1.9865,
+  -1.880, -1.785,
+  -(0.0435 + 19 * 0.087), -(0.0435 + 18 * 0.087),
+  -(0.0435 + 17 * 0.087), -(0.0435 + 16 * 0.087),
+  -(0.0435 + 15 * 0.087), -(0.0435 + 14 * 0.087),
+  -(0.0435 + 13 * 0.087), -(0.0435 + 12 * 0.087),
+  -(0.0435 + 11 * 0.087), -(0.0435 + 10 * 0.087),
+  -(0.0435 + 9 * 0.087), -(0.0435 + 8 * 0.087),
+  -(0.0435 + 7 * 0.087), -(0.0435 + 6 * 0.087),
+  -(0.0435 + 5 * 0.087), -(0.0435 + 4 * 0.087),
+  -(0.0435 + 3 * 0.087), -(0.0435 + 2 * 0.087),
+  -(0.0435 + 1 * 0.087), -(0.0435 + 0 * 0.087),
+  0.0435 + 0 * 0.087, 0.0435 + 1 * 0.087,
+  0.0435 + 2 * 0.087, 0.0435 + 3 * 0.087,
+  0.0435 + 4 * 0.087, 0.0435 + 5 * 0.087,
+  0.0435 + 6 * 0.087, 0.0435 + 7 * 0.087,
+  0.0435 + 8 * 0.087, 0.0435 + 9 * 0.087,
+  0.0435 + 10 * 0.087, 0.0435 + 11 * 0.087,
+  0.0435 + 12 * 0.087, 0.0435 + 13 * 0.087,
+  0.0435 + 14 * 0.087, 0.0435 + 15 * 0.087,
+  0.0435 + 16 * 0.087, 0.0435 + 17 * 0.087,
+  0.0435 + 18 * 0.087, 0.0435 + 19 * 0.087,
+  1.785, 1.880,
+  1.9865, 2.1075,
+  2.247, 2.411,
+  2.575, 2.825
+};
+
+// Physical phi of each TPG tower.
+constexpr double tpgPhi[N_TPG_PHI] = {
+  2. * M_PI * 0 / 72., 2. * M_PI * 1 / 72.,
+  2. * M_PI * 2 / 72., 2. * M_PI * 3 / 72.,
+  2. * M_PI * 4 / 72., 2. * M_PI * 5 / 72.,
+  2. * M_PI * 6 / 72., 2. * M_PI * 7 / 72.,
+  2. * M_PI * 8 / 72., 2. * M_PI * 9 / 72.,
+  2. * M_PI * 10 / 72., 2. * M_PI * 11 / 72.,
+  2. * M_PI * 12 / 72., 2. * M_PI * 13 / 72.,
+  2. * M_PI * 14 / 72., 2. * M_PI * 15 / 72.,
+  2. * M_PI * 16 / 72., 2. * M_PI * 17 / 72.,
+  2. * M_PI * 18 / 72., 2. * M_PI * 19 / 72.,
+  2. * M_PI * 20 / 72., 2. * M_PI * 21 / 72.,
+  2. * M_PI * 22 / 72., 2. * M_PI * 23 / 72.,
+  2. * M_PI * 24 / 72., 2. * M_PI * 25 / 72.,
+  2. * M_PI * 26 / 72., 2. * M_PI * 27 / 72.,
+  2. * M_PI * 28 / 72., 2. * M_PI * 29 / 72.,
+  2. * M_PI * 30 / 72., 2. * M_PI * 31 / 72.,
+  2. * M_PI * 32 / 72., 2. * M_PI * 33 / 72.,
+  2. * M_PI * 34 / 72., 2. * M_PI * 35 / 72.,
+  2. * M_PI * 36 / 72., -M_PI + 2. * M_PI * 1 / 72.,
+  -M_PI + 2. * M_PI * 2 / 72., -M_PI + 2. * M_PI * 3 / 72.,
+  -M_PI + 2. * M_PI * 4 / 72., -M_PI + 2. * M_PI * 5 / 72.,
+  -M_PI + 2. * M_PI * 6 / 72., -M_PI + 2. * M_PI * 7 / 72.,
+  -M_PI + 2. * M_PI * 8 / 72., -M_PI + 2. * M_PI * 9 / 72.,
+  -M_PI + 2. * M_PI * 10 / 72., -M_PI + 2. * M_PI * 11 / 72.,
+  -M_PI + 2. * M_PI * 12 / 72., -M_PI + 2. * M_PI * 13 / 72.,
+  -M_PI + 2. * M_PI * 14 / 72., -M_PI + 2. * M_PI * 15 / 72.,
+  -M_PI + 2. * M_PI * 16 / 72., -M_PI + 2. * M_PI * 17 / 72.,
+  -M_PI + 2. * M_PI * 18 / 72., -M_PI + 2. * M_PI * 19 / 72.,
+  -M_PI + 2. * M_PI * 20 / 72., -M_PI + 2. * M_PI * 21 / 72.,
+  -M_PI + 2. * M_PI * 22 / 72., -M_PI + 2. * M_PI * 23 / 72.,
+  -M_PI + 2. * M_PI * 24 / 72., -M_PI + 2. * M_PI * 25 / 72.,
+  -M_PI + 2. * M_PI * 26 / 72., -M_PI + 2. * M_PI * 27 / 72.,
+  -M_PI + 2. * M_PI * 28 / 72., -M_PI + 2. * M_PI * 29 / 72.,
+  -M_PI + 2. * M_PI * 30 / 72., -M_PI + 2. * M_PI * 31 / 72.,
+  -M_PI + 2. * M_PI * 32 / 72., -M_PI + 2. * M_PI * 33 / 72.,
+  -M_PI + 2. * M_PI * 34 / 72., -M_PI + 2. * M_PI * 35 / 72.
+};
+
+// sin/cos of 2*pi*gctPhi/18, as used for the MET and MHT components.  These
+// are the values of the runtime sin()/cos() with pi = 3.1415927, written out to
+// full precision.
+constexpr double sinRegionPhi[N_RGN_PHI] = {
+  0.0, 0.3420201481713719, 0.6427876175870462,
+  0.866025411519473, 0.9848077565940069, 0.9848077485349589,
+  0.8660253883143694, 0.6427875820347647, 0.34202010456004306,
+  -4.641020666628482e-08, -0.3420201917827003, -0.6427876531393263,
+  -0.8660254347245747, -0.9848077646530528, -0.9848077404759088,
+  -0.8660253651092636, -0.6427875464824824, -0.3420200609487133
+};
+
+constexpr double cosRegionPhi[N_RGN_PHI] = {
+  1.0, 0.9396926190222167, 0.7660444364896656,
+  0.49999998660252726, 0.17364815735353867, -0.17364820305867,
+  -0.500000026794945, -0.7660444663215711, -0.9396926348954413,
+  -0.9999999999999989, -0.9396926031489898, -0.7660444066577584,
+  -0.4999999464101084, -0.17364811164840677, 0.17364824876380117,
+  0.5000000669873622, 0.7660444961534745, 0.939692650768664
+};
+
+} // namespace uctgeo
 
 // Get the physical phi for a given TPG index.
-double convertTPGPhi(int iPhi);
+inline double convertTPGPhi(int iPhi) {
+  return (unsigned)iPhi < (unsigned)uctgeo::N_TPG_PHI ? uctgeo::tpgPhi[iPhi] : -9;
+}
 
 // Get the physical eta for a given TPG index
-double convertTPGEta(int iEta);
+inline double convertTPGEta(int iEta) {
+  return (unsigned)iEta < (unsigned)uctgeo::N_TPG_ETA ? uctgeo::tpgEta[iEta] : -9;
+}
 
 // Convert a region index into physical phi (at center of region)
-double convertRegionPhi(int iPhi);
+inline double convertRegionPhi(int iPhi) {
+  return (unsigned)iPhi < (unsigned)uctgeo::N_RGN_PHI ? uctgeo::regionPhi[iPhi] : -9;
+}
 
 // Convert a region index into physical eta (at center of region)
-double convertRegionEta(int iEta);
+inline double convertRegionEta(int iEta) {
+  return (unsigned)iEta < (unsigned)uctgeo::N_RGN_ETA ? uctgeo::regionEta[iEta] : -9;
+}
 
 // Get the effective area of a region in a given eta slice.
-double getRegionArea(int gctEta);
+inline double getRegionArea(int gctEta) {
+  return (unsigned)gctEta < (unsigned)uctgeo::N_RGN_ETA ? uctgeo::regionArea[gctEta] : 0;
+}
 
 // Find GCT index of a given tower.
 int twrPhi2RegionPhi(int iPhi);
@@ -3,15 +3,19 @@
 #include <math.h>
 #include <vector>
 #include <list>
+#include <mutex>
 #include <TTree.h>
 
 // user include files
 #include "FWCore/Framework/interface/Frameworkfwd.h"
-#include "FWCore/Framework/interface/EDProducer.h"
+#include "FWCore/Framework/interface/global/EDProducer.h"
 #include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/LuminosityBlock.h"
 #include "FWCore/Framework/interface/MakerMacros.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "FWCore/ServiceRegistry/interface/Service.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Exception.h"
 
 #include "DataFormats/L1CaloTrigger/interface/L1CaloCollections.h"
 #include "DataFormats/L1CaloTrigger/interface/L1CaloMipQuietRegion.h"
@@ -21,13 +25,29 @@
 
 #include "L1Trigger/UCT2015/interface/UCTCandidate.h"
 #include "L1Trigger/UCT2015/interface/helpers.h"
+#include "L1Trigger/UCT2015/interface/UCTRegionCorrectionTable.h"
+#include "L1Trigger/UCT2015/interface/UCTCalibrationFile.h"
+#include "L1Trigger/UCT2015/interface/UCTCore.h"
+#include "L1Trigger/UCT2015/interface/UCTCoreAdapters.h"
 
 #include "CommonTools/UtilAlgos/interface/TFileService.h"
 
 using namespace std;
 using namespace edm;
 
-class RegionCorrection : public edm::EDProducer {
+// The correction table of a luminosity block, and the checksum of the
+// calibration file it was read from (0 if there is none).
+struct RegionCorrectionCalibration {
+	std::shared_ptr<const UCTRegionCorrectionTable> table;
+	uint32_t checksum;
+};
+
+// The correction table is held per luminosity block, so that regionSF and
+// regionSubtraction can be reloaded from a calibration file between blocks;
+// the checksum of the file used is put in each block as CalibrationChecksum.
+class RegionCorrection :
+	public edm::global::EDProducer<edm::LuminosityBlockCache<RegionCorrectionCalibration>,
+				       edm::EndLuminosityBlockProducer> {
 	public:
 
 		// Concrete collection of output objects (with extra tuning information)
@@ -37,7 +57,15 @@ class RegionCorrection : public edm::EDProducer {
 		explicit RegionCorrection(const edm::ParameterSet&);
 
 	private:
-		virtual void produce(edm::Event&, const edm::EventSetup&);
+		virtual void produce(edm::StreamID, edm::Event&, const edm::EventSetup&) const;
+		virtual std::shared_ptr<RegionCorrectionCalibration>
+		globalBeginLuminosityBlock(const edm::LuminosityBlock&, const edm::EventSetup&) const;
+		virtual void globalEndLuminosityBlock(const edm::LuminosityBlock&, const edm::EventSetup&) const {}
+		virtual void globalEndLuminosityBlockProduce(edm::LuminosityBlock&, const edm::EventSetup&) const;
+
+		// Reread the tables if the calibration file has changed.  False,
+		// with the current table kept, if it cannot be read.
+		bool updateCalibration(std::string* error) const;
 
 		//Note the physical definitions are here but not used in calculation
                 double egPhysicalEt(const L1CaloEmCand& cand) const {
@@ -49,16 +77,6 @@ class RegionCorrection : public edm::EDProducer {
 			return regionLSB_*cand.et();
 		}
 
-		//These are the definitions used in calculation below
-                double egEt(const L1CaloEmCand& cand) const {
-                        return cand.rank();
-                }
-
-		//These are the definitions used in calculation below
-		double regionEt(const L1CaloRegion& cand) const {
-			return cand.et();
-		}
-
 
 		// Helper methods
 
@@ -66,21 +84,28 @@ class RegionCorrection : public edm::EDProducer {
 
 		bool debug_;
 
-		unsigned int puMult;
 		bool puMultCorrect_;
                 bool applyCalibration_;
 
                 InputTag uctDigis_;
+                edm::EDGetTokenT<L1CaloRegionCollection> regionToken_;
+                edm::EDGetTokenT<L1CaloEmCollection> emCandToken_;
 
 		//egLSB and regionLSB no longer used
                 double egLSB_;
 		double regionLSB_;
 
-		L1CaloRegionCollection CorrectedRegionList;
 		vector<double> m_regionSF;
 		vector<double> m_regionSubtraction;
-                int pumbin;
-                
+		// The calibration file to take the tables from, if any.
+		std::string regionSFTable_;
+		std::string regionSubtractionTable_;
+		mutable std::unique_ptr<uctcalib::Watcher> calibration_;
+		// The table of m_regionSF and m_regionSubtraction (or of the tables
+		// last read from the calibration file) per (eta, pumbin).  Guarded
+		// by calibrationMutex_, the table itself is read-only.
+		mutable std::shared_ptr<RegionCorrectionCalibration> currentCalibration_;
+		mutable std::mutex calibrationMutex_;
 
 };
 
@@ -89,21 +114,88 @@ RegionCorrection::RegionCorrection(const edm::ParameterSet& iConfig) :
         debug_(iConfig.getUntrackedParameter<bool>("debug",false)),
 	puMultCorrect_(iConfig.getParameter<bool>("puMultCorrect")),
         applyCalibration_(iConfig.getParameter<bool>("applyCalibration")),
-        uctDigis_(iConfig.getUntrackedParameter<edm::InputTag>("uctDigisTag", edm::InputTag("uctDigis"))),
+        uctDigis_(iConfig.getParameter<edm::InputTag>("uctDigisTag")),
 
         egLSB_(iConfig.getParameter<double>("egammaLSB")),
 	regionLSB_(iConfig.getParameter<double>("regionLSB"))
 {
 	m_regionSF=iConfig.getParameter<vector<double> >("regionSF");
 	m_regionSubtraction=iConfig.getParameter<vector<double> >("regionSubtraction");
+	std::shared_ptr<UCTRegionCorrectionTable> table(new UCTRegionCorrectionTable);
+	string error;
+	if(!table->build(m_regionSF, m_regionSubtraction, applyCalibration_, puMultCorrect_, &error))
+		throw cms::Exception("Configuration") << "RegionCorrection: " << error;
+	currentCalibration_.reset(new RegionCorrectionCalibration);
+	currentCalibration_->table = table;
+	currentCalibration_->checksum = 0;
+	string calibrationFile = iConfig.getParameter<string>("calibrationFile");
+	if(!calibrationFile.empty()) {
+		regionSFTable_ = iConfig.getParameter<string>("regionSFTable");
+		regionSubtractionTable_ = iConfig.getParameter<string>("regionSubtractionTable");
+		calibration_.reset(new uctcalib::Watcher(calibrationFile));
+		produces<unsigned int, edm::InLumi>("CalibrationChecksum");
+		if(!updateCalibration(&error))
+			throw cms::Exception("Configuration") << "RegionCorrection: " << error;
+	}
+	regionToken_ = consumes<L1CaloRegionCollection>(uctDigis_);
+	emCandToken_ = consumes<L1CaloEmCollection>(uctDigis_);
 	produces<L1CaloRegionCollection>("CorrectedRegions");
         produces<int>("PUM0Level");
 }
 
 
+bool RegionCorrection::updateCalibration(std::string* error) const
+{
+	std::shared_ptr<const uctcalib::File> file = calibration_->update(error);
+	if(!file) return error->empty();
+	vector<double> regionSF, regionSubtraction;
+	if(!file->get(regionSFTable_, &regionSF) ||
+	   !file->get(regionSubtractionTable_, &regionSubtraction)) {
+		*error = file->fileName() + " has no table " + regionSFTable_ +
+			" or " + regionSubtractionTable_;
+		return false;
+	}
+	std::shared_ptr<UCTRegionCorrectionTable> table(new UCTRegionCorrectionTable);
+	if(!table->build(regionSF, regionSubtraction, applyCalibration_, puMultCorrect_, error)) {
+		*error = file->fileName() + ": " + *error;
+		return false;
+	}
+	std::shared_ptr<RegionCorrectionCalibration> calibration(new RegionCorrectionCalibration);
+	calibration->table = table;
+	calibration->checksum = file->checksum();
+	currentCalibration_ = calibration;
+	calibration_->accept(file);
+	edm::LogInfo("RegionCorrection") << "regionSF and regionSubtraction read from "
+		<< file->fileName() << " (checksum " << std::hex << file->checksum() << ")";
+	return true;
+}
+
+std::shared_ptr<RegionCorrectionCalibration>
+RegionCorrection::globalBeginLuminosityBlock(const edm::LuminosityBlock&, const edm::EventSetup&) const
+{
+	std::lock_guard<std::mutex> lock(calibrationMutex_);
+	if(calibration_) {
+		string error;
+		if(!updateCalibration(&error))
+			edm::LogWarning("RegionCorrection") << error << ", keeping the previous tables";
+	}
+	return currentCalibration_;
+}
+
+void
+RegionCorrection::globalEndLuminosityBlockProduce(edm::LuminosityBlock& iLumi, const edm::EventSetup&) const
+{
+	if(!calibration_) return;
+	std::auto_ptr<unsigned int> checksum(
+		new unsigned int(luminosityBlockCache(iLumi.index())->checksum));
+	iLumi.put(checksum, "CalibrationChecksum");
+}
+
 	void
-RegionCorrection::produce(edm::Event& iEvent, const edm::EventSetup& iSetup)
+RegionCorrection::produce(edm::StreamID, edm::Event& iEvent, const edm::EventSetup& iSetup) const
 {
+	const UCTRegionCorrectionTable& correctionTable =
+		*luminosityBlockCache(iEvent.getLuminosityBlock().index())->table;
 	std::auto_ptr<L1CaloRegionCollection> CorrectedRegions(new L1CaloRegionCollection);
         std::auto_ptr<int> PUM0Level(new int);
 
@@ -111,100 +203,37 @@ RegionCorrection::produce(edm::Event& iEvent, const edm::EventSetup& iSetup)
 	Handle<L1CaloRegionCollection> notCorrectedRegions;
         Handle<L1CaloEmCollection> EMCands;
 
-	iEvent.getByLabel(uctDigis_, notCorrectedRegions);
-        iEvent.getByLabel(uctDigis_, EMCands);
+	iEvent.getByToken(regionToken_, notCorrectedRegions);
+        iEvent.getByToken(emCandToken_, EMCands);
 
-	//-------- does something with the notCorrectedRegions
-	puMult = 0;
 	//This calulates PUM0
+	unsigned int puMult = 0;
 	for(L1CaloRegionCollection::const_iterator notCorrectedRegion =
 			notCorrectedRegions->begin();
 			notCorrectedRegion != notCorrectedRegions->end(); notCorrectedRegion++){
-		double regionET =  regionEt(*notCorrectedRegion);
-		if (regionET > 0) {puMult++;}
+		if (notCorrectedRegion->et() > 0) {puMult++;}
+	}
+        int pumbin = UCTRegionCorrectionTable::pumBin(puMult); //396 Regions. Bins are 22 wide. Dividing by 22 gives which bin# of the 18 bins. 
+
+	// The correction is the one of uctcore::correctRegions (see
+	// UCTCore.h), done directly on the input collections.
+	uctcore::Ecal2x1Grid ecal2x1;
+	for(L1CaloEmCollection::const_reverse_iterator egtCand = EMCands->rbegin();
+			egtCand != EMCands->rend(); egtCand++){
+		ecal2x1.set(egtCand->regionId().ieta(), egtCand->regionId().iphi(), egtCand->rank());
 	}
-        pumbin = (int) puMult/22; //396 Regions. Bins are 22 wide. Dividing by 22 gives which bin# of the 18 bins. 
-
 
-	CorrectedRegionList.clear();
+	CorrectedRegions->reserve(notCorrectedRegions->size());
 	for(L1CaloRegionCollection::const_iterator notCorrectedRegion =
 			notCorrectedRegions->begin();
 			notCorrectedRegion != notCorrectedRegions->end(); notCorrectedRegion++){
-		double regionET =  regionEt(*notCorrectedRegion);
 		unsigned int regionEta = notCorrectedRegion->gctEta();
-
-               int regionEtCorr=0;
-
-                // Only non-empty regions are corrected
-                if(regionET!=0) {
-
-
-                double energyECAL2x1=0;
-                // Find associated 2x1 ECAL energy (EG are calibrated, we should not scale them up, it affects the isolation routines)
-                // 2x1 regions have the MAX tower contained in the 4x4 region that its position points to.
-                // This is to not break isolation.
-                for(L1CaloEmCollection::const_iterator egtCand =EMCands->begin(); egtCand != EMCands->end(); egtCand++){
-                        double et = egEt(*egtCand);
-                        if(egtCand->regionId().iphi() == notCorrectedRegion->gctPhi() &&  egtCand->regionId().ieta() == notCorrectedRegion->gctEta()) {
-                                energyECAL2x1=et;
-                                break;  // I do not really like "breaks"
-                        }
-                }
-
-		double alpha = m_regionSF[2*regionEta + 0]; //Region Scale factor (See regionSF_cfi.py)
-		double gamma = 2*((m_regionSF[2*regionEta + 1])/3); //Region Offset. It needs to be divided by nine from the 
-                                                                    //jet derived value in the lookup table. (See regionSF_cfi.py) Multiplied by 2 
-                                                                    //because gamma is given in regionPhysicalET (=regionEt*regionLSB), and we want regionEt= physicalEt/LSB and LSB=.5.
-                if(!applyCalibration_ || regionET<20) {alpha=1;  gamma=0;}
-
-
-
-		double puSub = m_regionSubtraction[18*regionEta+pumbin]*2;
-          	//The values in m_regionSubtraction are MULTIPLIED by RegionLSB=.5 (physicalRegionEt), so 
-          	//to get back unmultiplied regionSubtraction we want to multiply the number by 2 (aka divide by LSB).
-                if(!puMultCorrect_) puSub=0; 
-
-
-                if(regionET - puSub<1) {regionEtCorr =0 ;} 
-                else {
-		        double pum0pt =  (int) (regionET - puSub-energyECAL2x1); //subtract ECAl energy 
-		        double corrpum0pt = pum0pt*alpha+gamma+energyECAL2x1; //add back in ECAL energy, calibrate regions(not including the ECAL2x1).
-
-		        if (corrpum0pt<0) {corrpum0pt=0;} //zero floor
-
-		        regionEtCorr = (int) (corrpum0pt);	
-                }
-                if(debug_){
-                        std::cout<<regionEta<<"   "<<regionET<<"   "<<energyECAL2x1<<"   "<<puSub<<"     "<<alpha<<"     "<<gamma<<"-->"<<regionEtCorr<<"   "<<std::endl;
-                        }
-                }
-
-		if(regionEta<18 && regionEta>3) //if !hf
-		{		
-
-			bool overflow=notCorrectedRegion->overFlow();
-			bool tau=notCorrectedRegion->tauVeto();
-			bool mip=notCorrectedRegion->mip();
-			bool quiet= notCorrectedRegion->quiet();
-			unsigned crate=notCorrectedRegion->rctCrate();
-			unsigned card=notCorrectedRegion->rctCard();
-			unsigned rgn=notCorrectedRegion->rctRegionIndex();
-			CorrectedRegionList.push_back(L1CaloRegion(regionEtCorr, overflow, tau,mip,quiet,crate,card,rgn));
-		}
-		else //if hf
-		{
-			bool fineGrain= notCorrectedRegion->fineGrain();
-			unsigned crate= notCorrectedRegion->rctCrate();
-			unsigned hfRgn=notCorrectedRegion->rctRegionIndex();
-			CorrectedRegionList.push_back(L1CaloRegion(regionEtCorr,fineGrain,crate, hfRgn));
-		}
-
+		unsigned int regionEtCorr = uctcore::correctedEt(correctionTable, pumbin,
+			regionEta, notCorrectedRegion->et(),
+			ecal2x1.at(regionEta, notCorrectedRegion->gctPhi()),
+			debug_ ? &std::cout : 0);
+		CorrectedRegions->push_back(uctcore::makeCorrectedL1CaloRegion(*notCorrectedRegion, regionEtCorr));
 	}
-	for(L1CaloRegionCollection::const_iterator CorrectedNewRegion = CorrectedRegionList.begin();
-			CorrectedNewRegion != CorrectedRegionList.end(); ++CorrectedNewRegion) {
-		CorrectedRegions->push_back(*CorrectedNewRegion);
-	}
-
         (*PUM0Level) = pumbin; 
         
 	iEvent.put(CorrectedRegions, "CorrectedRegions");
@@ -32,6 +32,7 @@
 #include "DataFormats/L1CaloTrigger/interface/L1CaloCollections.h"
 
 #include "L1Trigger/UCT2015/interface/UCTCandidate.h"
+#include "L1Trigger/UCT2015/interface/UCTCore.h"
 
 // GCT data includes
 #include "DataFormats/L1GlobalCaloTrigger/interface/L1GctCollections.h"
@@ -153,18 +154,15 @@ void UCT2015GctCandsProducer::produce(edm::Event& e, const edm::EventSetup& c) {
       }
       else {
                 for( unsigned int i = 0 ; i<egObjs->size() && i<maxEGs_; i++){
-                        UCTCandidate itr=egObjs->at(i);
-                        double ET=itr.pt();
-                        if(saturateEG_ && itr.pt()>=63) ET=63;   //something about the scale got messed up after 63! Saturating...
-                        unsigned iEta=itr.getInt("rgnEta");
-                        unsigned iPhi=itr.getInt("rgnPhi");
-                        unsigned rctEta=itr.getInt("rctEta");
-                        unsigned gctEta=((rctEta & 0x7) | (iEta<11 ? 0x8 : 0x0));
+                        const UCTCandidate& itr=egObjs->at(i);
+                        double ET=uctcore::gctSaturatedEgEt(itr.pt(), saturateEG_);
+                        unsigned iPhi=itr.rgnPhi();
+                        unsigned gctEta=uctcore::gctEmEta(itr.rgnEta(), itr.rctEta());
                         unsigned rank = emScale->rank( ET) ;
 
-                        //std::cout<<"EG -->"<<itr.pt()<<"   "<<itr.getInt("isIsolated")<<"   --->"<<rlxEmResult->size()<<std::endl;
+                        //std::cout<<"EG -->"<<itr.pt()<<"   "<<itr.isIsolated()<<"   --->"<<rlxEmResult->size()<<std::endl;
                         
-                        if(itr.getInt("isIsolated")) continue;
+                        if(itr.isIsolated()) continue;
 
                         L1GctEmCand gctEmCand=L1GctEmCand(rank,iPhi,gctEta,0);        
                         rlxEmResult->push_back( gctEmCand  );
@@ -188,14 +186,10 @@ void UCT2015GctCandsProducer::produce(edm::Event& e, const edm::EventSetup& c) {
       }
       else {
                 for( unsigned int i = 0 ; i<egObjsIso->size() && i<maxIsoEGs_; i++){
-                        UCTCandidate itr=egObjsIso->at(i);
-                        double ET=itr.pt();
-                        if(saturateEG_ && itr.pt()>=63) ET=63;
-                        unsigned iEta=itr.getInt("rgnEta");
-                        unsigned iPhi=itr.getInt("rgnPhi");
-                        unsigned rctEta=itr.getInt("rctEta");
-
-                        unsigned gctEta=((rctEta & 0x7) | (iEta<11 ? 0x8 : 0x0));
+                        const UCTCandidate& itr=egObjsIso->at(i);
+                        double ET=uctcore::gctSaturatedEgEt(itr.pt(), saturateEG_);
+                        unsigned iPhi=itr.rgnPhi();
+                        unsigned gctEta=uctcore::gctEmEta(itr.rgnEta(), itr.rctEta());
 
                         unsigned rank = emScale->rank( ET) ;
 
@@ -222,14 +216,12 @@ void UCT2015GctCandsProducer::produce(edm::Event& e, const edm::EventSetup& c) {
       }
       else {
                 for( unsigned int i = 0 ; i<tauObjsIso->size() && i<maxIsoTaus_; i++){
-                        UCTCandidate itr=tauObjsIso->at(i);
-                        unsigned iEta=itr.getInt("rgnEta");
-                        unsigned iPhi=itr.getInt("rgnPhi");
-                        unsigned rctEta=itr.getInt("rctEta");
-                        unsigned hwEta=(((rctEta % 7) & 0x7) | (iEta<11 ? 0x8 : 0));
-                        unsigned hwPhi= iPhi& 0x1f;
+                        const UCTCandidate& itr=tauObjsIso->at(i);
+                        unsigned rctEta=itr.rctEta();
+                        unsigned hwEta=uctcore::gctJetEta(itr.rgnEta(), rctEta);
+                        unsigned hwPhi=uctcore::gctJetPhi(itr.rgnPhi());
                         const int16_t bx=0; 
-                        //double pt=itr.getFloat("associatedRegionEt");
+                        //double pt=itr.getFloat(uctkey::associatedRegionEt);
                         double pt=itr.pt();
                         unsigned rank = jetScale->rank(pt);
                         bool isFor=false;
@@ -256,17 +248,15 @@ void UCT2015GctCandsProducer::produce(edm::Event& e, const edm::EventSetup& c) {
       }
       else {
                 for( unsigned int i = 0 ; i<jetObjs->size() &&  i<maxJets_; i++){
-                        UCTCandidate itr=jetObjs->at(i);
-                        unsigned iEta=itr.getInt("rgnEta");
-                        unsigned iPhi=itr.getInt("rgnPhi");
-                        unsigned rctEta=itr.getInt("rctEta");
-                        unsigned hwEta=(((rctEta % 7) & 0x7) | (iEta<11 ? 0x8 : 0));
-                        unsigned hwPhi= iPhi& 0x1f;
+                        const UCTCandidate& itr=jetObjs->at(i);
+                        unsigned rctEta=itr.rctEta();
+                        unsigned hwEta=uctcore::gctJetEta(itr.rgnEta(), rctEta);
+                        unsigned hwPhi=uctcore::gctJetPhi(itr.rgnPhi());
                         bool isTau=false;
                         const int16_t bx=0; 
                         unsigned rank = jetScale->rank(itr.pt()) ;
 
-                        bool isFor=(rctEta>=7);
+                        bool isFor=uctcore::gctIsForwardJet(rctEta);
                         L1GctJetCand gctJetCand=L1GctJetCand(rank, hwPhi, hwEta, isTau , isFor,(uint16_t) 0, (uint16_t) 0, bx);
                         if (!isFor) cenJetResult->push_back( gctJetCand  );
                 }
@@ -276,17 +266,15 @@ void UCT2015GctCandsProducer::produce(edm::Event& e, const edm::EventSetup& c) {
                                 cenJetResult->push_back( gctJetCand  );
                         }
                 for( unsigned int i = 0 ; i<maxJets_ && i<jetObjs->size(); i++){
-                        UCTCandidate itr=jetObjs->at(i);
-                        unsigned iEta=itr.getInt("rgnEta");
-                        unsigned iPhi=itr.getInt("rgnPhi");
-                        unsigned rctEta=itr.getInt("rctEta");
-                        unsigned hwEta=(((rctEta % 7) & 0x7) | (iEta<11 ? 0x8 : 0));
-                        unsigned hwPhi= iPhi& 0x1f;
+                        const UCTCandidate& itr=jetObjs->at(i);
+                        unsigned rctEta=itr.rctEta();
+                        unsigned hwEta=uctcore::gctJetEta(itr.rgnEta(), rctEta);
+                        unsigned hwPhi=uctcore::gctJetPhi(itr.rgnPhi());
                         bool isTau=false;
                         const int16_t bx=0; 
                         unsigned rank = jetScale->rank(itr.pt()) ;
 
-                        bool isFor=(rctEta>=7);
+                        bool isFor=uctcore::gctIsForwardJet(rctEta);
                         L1GctJetCand gctJetCand=L1GctJetCand(rank, hwPhi, hwEta, isTau , isFor,(uint16_t) 0, (uint16_t) 0, bx);
                         if (isFor) forJetResult->push_back( gctJetCand  );
                 }
@@ -310,10 +298,9 @@ void UCT2015GctCandsProducer::produce(edm::Event& e, const edm::EventSetup& c) {
       }
       else {
                 if(setObjs->size()>0){ // This is just for safety        
-                        UCTCandidate itr=setObjs->at(0);
+                        const UCTCandidate& itr=setObjs->at(0);
                         const int16_t bx=0; // ???
-                        double convert=itr.pt()/etSumLSB;
-                        unsigned rank=(unsigned)convert;
+                        unsigned rank=uctcore::gctSumRank(itr.pt(), etSumLSB);
                         L1GctEtTotal gctSumEt=L1GctEtTotal(rank, 0, bx);
                         etTotResult->push_back(gctSumEt);        
 
@@ -331,9 +318,8 @@ void UCT2015GctCandsProducer::produce(edm::Event& e, const edm::EventSetup& c) {
       }
       else {
                 if(shtObjs->size()>0){ // This is just for safety
-                        UCTCandidate itr=shtObjs->at(0);
-                        double convert=itr.pt()/htSumLSB;
-                        unsigned rank=(unsigned)convert;
+                        const UCTCandidate& itr=shtObjs->at(0);
+                        unsigned rank=uctcore::gctSumRank(itr.pt(), htSumLSB);
                         const int16_t bx=0; // ???
                         L1GctEtHad gctSumHt=L1GctEtHad(rank, 0, bx);
                         etHadResult->push_back(gctSumHt);
@@ -353,12 +339,9 @@ void UCT2015GctCandsProducer::produce(edm::Event& e, const edm::EventSetup& c) {
       }
       else {
                 if(metObjs->size()>0){ // This is just for safety
-                        UCTCandidate itr=metObjs->at(0);
-                        double phiMod=36.*itr.phi()/M_PI;
-                        if(phiMod<0) phiMod  += 72;
-                        unsigned iPhi = (unsigned)phiMod;
-                        double convert=itr.pt()/etSumLSB;
-                        unsigned rank=(unsigned)convert;
+                        const UCTCandidate& itr=metObjs->at(0);
+                        unsigned iPhi = uctcore::gctMETPhi(itr.phi());
+                        unsigned rank=uctcore::gctSumRank(itr.pt(), etSumLSB);
                         L1GctEtMiss gctMET=L1GctEtMiss(rank, iPhi, 0);  
                         etMissResult->push_back(gctMET);
                         }
@@ -376,10 +359,8 @@ void UCT2015GctCandsProducer::produce(edm::Event& e, const edm::EventSetup& c) {
       }
       else {
                 if(mhtObjs->size()>0){ // This is just for safety
-                        UCTCandidate itr=mhtObjs->at(0);
-                        double phiMod=9.*itr.phi()/M_PI;
-                        if(phiMod<0) phiMod  += 18.0;
-                        unsigned iPhi = (unsigned)phiMod;
+                        const UCTCandidate& itr=mhtObjs->at(0);
+                        unsigned iPhi = uctcore::gctMHTPhi(itr.phi());
                         unsigned rank=htMissScale->rank(itr.pt());
                         L1GctHtMiss gctMHT=L1GctHtMiss(rank, iPhi, 0);  
                         htMissResult->push_back(gctMHT);
@@ -10,24 +10,32 @@
 #include <memory>
 #include <math.h>
 #include <vector>
-#include <list>
+#include <atomic>
+#include <mutex>
 #include <TTree.h>
 
 // user include files
 #include "FWCore/Framework/interface/Frameworkfwd.h"
-#include "FWCore/Framework/interface/EDProducer.h"
+#include "FWCore/Framework/interface/global/EDProducer.h"
 
 #include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/LuminosityBlock.h"
 #include "FWCore/Framework/interface/MakerMacros.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Exception.h"
 
 #include "DataFormats/L1CaloTrigger/interface/L1CaloCollections.h"
 #include "DataFormats/L1CaloTrigger/interface/L1CaloRegion.h"
 #include "DataFormats/L1CaloTrigger/interface/L1CaloEmCand.h"
 #include "DataFormats/L1CaloTrigger/interface/L1CaloRegionDetId.h"
 
+#include "L1Trigger/UCT2015/interface/UCTCalibrationFile.h"
 #include "L1Trigger/UCT2015/interface/UCTCandidate.h"
-#include "L1Trigger/UCT2015/interface/helpers.h"
+#include "L1Trigger/UCT2015/interface/UCTCandidateTable.h"
+#include "L1Trigger/UCT2015/interface/UCTCore.h"
+#include "L1Trigger/UCT2015/interface/UCTCoreAdapters.h"
+#include "L1Trigger/UCT2015/interface/UCTRegionCorrectionTable.h"
 
 #include "FWCore/ServiceRegistry/interface/Service.h"
 #include "CommonTools/UtilAlgos/interface/TFileService.h"
@@ -38,7 +46,36 @@ using namespace std;
 using namespace edm;
 
 
-class UCT2015Producer : public edm::EDProducer {
+// All the state of the algorithm for one event.  Each stream has its own,
+// which is reused from one event to the next.
+struct UCT2015EventContext {
+  explicit UCT2015EventContext(bool useEventArena) :
+    state(useEventArena), stagesDone_(0) {}
+
+  uctcore::EventState state;
+  // Stages run in the current event (bit mask)
+  unsigned int stagesDone_;
+};
+
+// The emulation parameters of a luminosity block, and the checksum of the
+// calibration file they were read from (0 if there is none).
+struct UCT2015Calibration {
+  std::shared_ptr<const uctcore::Config> config;
+  uint32_t checksum;
+};
+
+// The emulation itself is done by the uctcore functions (see UCTCore.h);
+// this module converts the RCT digis for them, runs the stages needed for
+// the requested outputs and puts the results into the event.  The
+// emulation parameters are held per luminosity block, so that the jet
+// calibration can be reloaded from a calibration file between blocks; the
+// checksum of the file used is put in each block as CalibrationChecksum.
+// With fuseRegionCorrection the PUM0 correction of RegionCorrection is
+// done here too, as the first stage, on the uncorrected regions.
+class UCT2015Producer :
+  public edm::global::EDProducer<edm::StreamCache<UCT2015EventContext>,
+				 edm::LuminosityBlockCache<UCT2015Calibration>,
+				 edm::EndLuminosityBlockProducer> {
 public:
 
   static const unsigned N_JET_PHI;
@@ -48,989 +85,475 @@ public:
   typedef vector<UCTCandidate> UCTCandidateCollection;
   typedef std::auto_ptr<UCTCandidateCollection> UCTCandidateCollectionPtr;
 
+  // The processing steps of produce().  Each stage declares the stages it
+  // reads from and runs at most once per event, after them.  The region
+  // correction is only a stage when it is fused; otherwise the corrected
+  // regions and puLevelPUM0 are read from the event, and it is dropped
+  // from the graph.
+  enum Stage {
+    kRegionCorrection, // regions (PUM0 corrected), puLevelPUM0
+    kPUEstimate,       // puLevelHI, puLevelHIUIC, puLevelHIHI
+    kGrid,             // regionGrid, annulusCache
+    kSums,             // MET/MHT/SET/SHT objects
+    kJets,             // jetList, jetEtSums, jetIndex
+    kJetCalibration,   // corrJetList
+    kEGTaus,           // rlx/iso EG and ECAL seeded tau lists
+    kRegionTaus,       // rlx/iso region seeded tau lists
+    N_STAGES
+  };
+
+  // The output collections, in the order of the outputs table.
+  enum Collection {
+    kJetOut, kCorrJetOut,
+    kRlxEGOut, kIsoEGOut,
+    kRlxTauOut, kIsoTauOut,
+    kCorrRlxTauOut, kCorrIsoTauOut,
+    kRlxTauEcalSeedOut, kIsoTauEcalSeedOut,
+    kPULevelPUM0Out, kPULevelOut, kPULevelUICOut,
+    kMETOut, kMHTOut, kSETOut, kSHTOut,
+    N_COLLECTIONS
+  };
+
   explicit UCT2015Producer(const edm::ParameterSet&);
 
 private:
-  virtual void produce(edm::Event&, const edm::EventSetup&);
-
-  double egPhysicalEt(const L1CaloEmCand& cand) const {
-    return egLSB_*cand.rank();
-  }
-
-  double regionPhysicalEt(const L1CaloRegion& cand) const {
-    return std::max(0.,regionLSB_*cand.et());
-  }
-
-  // Find information about observables in the annulus.  We define the annulus
-  // as all regions around the central region, with the exception of the second
-  // highest in ET, as this could be sharing the 2x1.
-  // MIPS in annulus refers to number of regions in the annulus which have
-  // their MIP bit set.
-  // egFlags is the number where (!tauVeto && !mip)
-  void findAnnulusInfo(int ieta, int iphi,
-		       const L1CaloRegionCollection& regions,
-		       double* associatedSecondRegionEt,
-		       double* associatedThirdRegionEt,
-		       unsigned int* mipsInAnnulus,
-		       unsigned int* egFlagsInAnnulus,
-		       unsigned int* mipInSecondRegion) const;
-
-  // Helper methods
-
-  void puSubtraction();
-  void puMultSubtraction();
-
-  void makeSums();
-  void makeJets();
-  void makeEGTaus();
-  void makeTaus();
-
-  list<UCTCandidate> correctJets(const list<UCTCandidate>&, bool isJet);
+  virtual std::unique_ptr<UCT2015EventContext> beginStream(edm::StreamID) const;
+  virtual std::shared_ptr<UCT2015Calibration>
+  globalBeginLuminosityBlock(const edm::LuminosityBlock&, const edm::EventSetup&) const;
+  virtual void globalEndLuminosityBlock(const edm::LuminosityBlock&, const edm::EventSetup&) const {}
+  virtual void globalEndLuminosityBlockProduce(edm::LuminosityBlock&, const edm::EventSetup&) const;
+  virtual void produce(edm::StreamID, edm::Event&, const edm::EventSetup&) const;
+  virtual void endJob();
+
+  struct StageNode {
+    const char* name;
+    void (*run)(const uctcore::Config& config, uctcore::EventState& state);
+    // Bit mask of the stages this one depends on
+    unsigned int inputs;
+  };
+  static const StageNode stageNodes[N_STAGES];
+
+  // Run a stage, and before it any of its inputs, unless already done in
+  // this event.
+  void runStage(UCT2015EventContext& ctx, const uctcore::Config& config,
+		Stage stage) const;
+
+  // Reread jetSF (and the region correction tables, if fused) if the
+  // calibration file has changed.  False, with the current parameters
+  // kept, if it cannot be read.
+  bool updateCalibration(std::string* error) const;
+
+  // Put the corrected regions into the event, as RegionCorrection does.
+  void putCorrectedRegions(edm::Event& iEvent, const L1CaloRegionCollection& regions,
+			   const uctcore::EventState& state) const;
+  // Put a collection into the event, together with its UCTCandidateTable if
+  // produceCandidateTables is set.
+  void putCollection(edm::Event& iEvent, UCTCandidateCollectionPtr cands,
+		     const char* instance) const;
+  // Put a single object or a buffer as the given output, if it is produced.
+  // The buffer is emptied either way.
+  void putOutput(edm::Event& iEvent, Collection output,
+		 const uctcore::Candidate& obj) const;
+  void putOutput(edm::Event& iEvent, Collection output,
+		 uctcore::CandidateBuffer& buffer) const;
 
   // ----------member data ---------------------------
-  bool puCorrectHI;
-  bool applyJetCalibration;
   bool puMultCorrect;
-  //bool puCorrectHISums;
   bool useUICrho; // which PU denstity to use for energy correction determination
-  bool useHI; // do HI-style background subtraction
-
-  unsigned int puETMax;
-  unsigned int puLevelHI;
-  unsigned int puLevelPUM0;
-  //double puLevelHIUIC; // puLevelHI divided by puCount*Area, not multiply by 9.0
-  unsigned int  puLevelHIUIC; // puLevelHI divided by puCount*Area, not multiply by 9.0
-  vector<int> puLevelHIHI;
-
-  unsigned int sumET;
-  int sumEx;
-  int sumEy;
-  unsigned int MET;
-
-  unsigned int regionETCutForHT;
-  unsigned int regionETCutForNeighbor;
-  unsigned int regionETCutForMET;
-
-  unsigned int minGctEtaForSums;
-  unsigned int maxGctEtaForSums;
-  unsigned int sumHT;
-  int sumHx;
-  int sumHy;
-  unsigned int MHT;
-
-  unsigned int sumExtraET;
-  unsigned int extraMET;
-  unsigned int sumExtraHT;
-  unsigned int extraMHT;
-
-  UCTCandidate METObject;
-  UCTCandidate MHTObject;
-  UCTCandidate SETObject;
-  UCTCandidate SHTObject;
-
-  unsigned int jetSeed;
-  list<UCTCandidate> jetList, corrJetList;
-
-  unsigned int egtSeed;
-  unsigned int tauSeed;
-
-  double relativeTauIsolationCut;
-  double relativeJetIsolationCut;
-  double switchOffTauIso;
-  list<UCTCandidate> rlxTauList, corrRlxTauList;
-  list<UCTCandidate> rlxEGList;
-  list<UCTCandidate> isoTauList, corrIsoTauList;
-  list<UCTCandidate> isoEGList;
-  list<UCTCandidate> rlxTauRegionOnlyList, isoTauRegionOnlyList;
-
-  Handle<L1CaloRegionCollection> newRegions;
-  Handle<L1CaloEmCollection> newEMCands;
-
-  vector<double> sinPhi;
-  vector<double> cosPhi;
-
-  double egLSB_;
-  double regionLSB_;
-
-  vector<double> m_jetSF;
+  // Do the region correction here instead of reading CorrectedDigis, and
+  // whether to put the corrected regions into the event then.
+  bool fuseRegionCorrection_;
+  bool produceCorrectedRegions_;
+  bool applyRegionCalibration_;
+
+  // The emulation parameters, as configured
+  uctcore::Config config_;
+
+  // The calibration file to take jetSF (and the region correction tables)
+  // from, if any, and the parameters
+  // with the constants last read from it.  Guarded by calibrationMutex_.
+  std::string jetSFTable_;
+  std::string regionSFTable_;
+  std::string regionSubtractionTable_;
+  mutable std::unique_ptr<uctcalib::Watcher> calibration_;
+  mutable std::shared_ptr<UCT2015Calibration> currentCalibration_;
+  mutable std::mutex calibrationMutex_;
+
+  bool produceCandidateTables_;
+  // Build the candidate collections in per-event arena memory
+  bool useEventArena_;
+
+  edm::EDGetTokenT<L1CaloRegionCollection> regionToken_;
+  edm::EDGetTokenT<L1CaloEmCollection> emCandToken_;
+  edm::EDGetTokenT<int> puLevelPUM0Token_;
+
+  // Which outputs are produced, the stages in the graph and the stages
+  // needed for the outputs (bit masks).
+  bool produced_[N_COLLECTIONS];
+  unsigned int stages_;
+  unsigned int outputStages_;
+
+  // How many times each stage has run in the job, over all streams.
+  mutable std::atomic<unsigned long> stageCount_[N_STAGES];
+  mutable std::atomic<unsigned long> eventCount_;
+  bool reportStageCounts_;
 
 };
 
 unsigned const UCT2015Producer::N_JET_PHI = L1CaloRegionDetId::N_PHI * 4;
 unsigned const UCT2015Producer::N_JET_ETA = L1CaloRegionDetId::N_ETA * 4;
 
+#define STAGE_BIT(s) (1u << UCT2015Producer::s)
+
+const UCT2015Producer::StageNode UCT2015Producer::stageNodes[N_STAGES] = {
+  { "RegionCorrection", &uctcore::correctRegions, 0 },
+  { "PUEstimate", &uctcore::estimatePU, STAGE_BIT(kRegionCorrection) },
+  { "Grid", &uctcore::buildGrid, STAGE_BIT(kRegionCorrection) },
+  { "Sums", &uctcore::makeSums,
+    STAGE_BIT(kRegionCorrection) | STAGE_BIT(kGrid) },
+  { "Jets", &uctcore::makeJets,
+    STAGE_BIT(kRegionCorrection) | STAGE_BIT(kPUEstimate) | STAGE_BIT(kGrid) },
+  { "JetCalibration", &uctcore::calibrateJets,
+    STAGE_BIT(kJets) },
+  { "EGTaus", &uctcore::makeEGTaus,
+    STAGE_BIT(kRegionCorrection) | STAGE_BIT(kPUEstimate) | STAGE_BIT(kGrid) |
+    STAGE_BIT(kJets) },
+  { "RegionTaus", &uctcore::makeTaus,
+    STAGE_BIT(kRegionCorrection) | STAGE_BIT(kPUEstimate) | STAGE_BIT(kGrid) |
+    STAGE_BIT(kJets) }
+};
+
+#undef STAGE_BIT
+
+// The output collections, and the stage which fills each of them.
+// N_STAGES means nothing fills it.
+static const struct {
+  const char* name;
+  int stage;
+} outputs[UCT2015Producer::N_COLLECTIONS] = {
+  { "JetUnpacked", UCT2015Producer::kJets },
+  { "CorrJetUnpacked", UCT2015Producer::kJetCalibration },
+  { "RelaxedEGUnpacked", UCT2015Producer::kEGTaus },
+  { "IsolatedEGUnpacked", UCT2015Producer::kEGTaus },
+  { "RelaxedTauUnpacked", UCT2015Producer::kRegionTaus },
+  { "IsolatedTauUnpacked", UCT2015Producer::kRegionTaus },
+  // nobody uses these
+  { "CorrRelaxedTauUnpacked", UCT2015Producer::N_STAGES },
+  { "CorrIsolatedTauUnpacked", UCT2015Producer::N_STAGES },
+  { "RelaxedTauEcalSeedUnpacked", UCT2015Producer::kEGTaus },
+  { "IsolatedTauEcalSeedUnpacked", UCT2015Producer::kEGTaus },
+  // read from the event unless the region correction is fused
+  { "PULevelPUM0Unpacked", UCT2015Producer::kRegionCorrection },
+  { "PULevelUnpacked", UCT2015Producer::kPUEstimate },
+  { "PULevelUICUnpacked", UCT2015Producer::kPUEstimate },
+  { "METUnpacked", UCT2015Producer::kSums },
+  { "MHTUnpacked", UCT2015Producer::kSums },
+  { "SETUnpacked", UCT2015Producer::kSums },
+  { "SHTUnpacked", UCT2015Producer::kSums }
+};
+
 //
 // constructors and destructor
 //
 UCT2015Producer::UCT2015Producer(const edm::ParameterSet& iConfig) :
-  puCorrectHI(iConfig.getParameter<bool>("puCorrectHI")), 
-  applyJetCalibration(iConfig.getParameter<bool>("applyJetCalibration")),
   puMultCorrect(iConfig.getParameter<bool>("puMultCorrect")),
   useUICrho(iConfig.getParameter<bool>("useUICrho")),
-  useHI(iConfig.getParameter<bool>("useHI")),
-  puETMax(iConfig.getParameter<unsigned int>("puETMax")),
-  regionETCutForHT(iConfig.getParameter<unsigned int>("regionETCutForHT")),
-  regionETCutForNeighbor(iConfig.getParameter<unsigned int>("regionETCutForNeighbor")),
-  regionETCutForMET(iConfig.getParameter<unsigned int>("regionETCutForMET")),
-  minGctEtaForSums(iConfig.getParameter<unsigned int>("minGctEtaForSums")),
-  maxGctEtaForSums(iConfig.getParameter<unsigned int>("maxGctEtaForSums")),
-  jetSeed(iConfig.getParameter<unsigned int>("jetSeed")),
-  egtSeed(iConfig.getParameter<unsigned int>("egtSeed")),
-  tauSeed(iConfig.getParameter<unsigned int>("tauSeed")),
-
-  relativeTauIsolationCut(iConfig.getParameter<double>("relativeTauIsolationCut")),
-  relativeJetIsolationCut(iConfig.getParameter<double>("relativeJetIsolationCut")),
-  switchOffTauIso(iConfig.getParameter<double>("switchOffTauIso")),
-  egLSB_(iConfig.getParameter<double>("egammaLSB")),
-  regionLSB_(iConfig.getParameter<double>("regionLSB"))
+  fuseRegionCorrection_(puMultCorrect &&
+			iConfig.getParameter<bool>("fuseRegionCorrection")),
+  produceCorrectedRegions_(fuseRegionCorrection_ &&
+			   iConfig.getParameter<bool>("produceCorrectedRegions")),
+  applyRegionCalibration_(fuseRegionCorrection_ &&
+			  iConfig.getParameter<bool>("applyRegionCalibration")),
+  produceCandidateTables_(iConfig.getParameter<bool>("produceCandidateTables")),
+  useEventArena_(iConfig.getUntrackedParameter<bool>("useEventArena", false)),
+  eventCount_(0),
+  reportStageCounts_(iConfig.getUntrackedParameter<bool>("reportStageCounts", false))
 {
-  m_jetSF=iConfig.getParameter<vector<double> >("jetSF");
+  config_.puCorrectHI = iConfig.getParameter<bool>("puCorrectHI");
+  config_.applyJetCalibration = iConfig.getParameter<bool>("applyJetCalibration");
+  config_.useHI = iConfig.getParameter<bool>("useHI");
+  config_.useFixedPointSumsAndJetSF = iConfig.getParameter<bool>("useFixedPointSumsAndJetSF");
+  config_.puETMax = iConfig.getParameter<unsigned int>("puETMax");
+  config_.regionETCutForHT = iConfig.getParameter<unsigned int>("regionETCutForHT");
+  config_.regionETCutForNeighbor = iConfig.getParameter<unsigned int>("regionETCutForNeighbor");
+  config_.regionETCutForMET = iConfig.getParameter<unsigned int>("regionETCutForMET");
+  config_.minGctEtaForSums = iConfig.getParameter<unsigned int>("minGctEtaForSums");
+  config_.maxGctEtaForSums = iConfig.getParameter<unsigned int>("maxGctEtaForSums");
+  config_.jetSeed = iConfig.getParameter<unsigned int>("jetSeed");
+  config_.egtSeed = iConfig.getParameter<unsigned int>("egtSeed");
+  config_.tauSeed = iConfig.getParameter<unsigned int>("tauSeed");
+  config_.relativeTauIsolationCut = iConfig.getParameter<double>("relativeTauIsolationCut");
+  config_.relativeJetIsolationCut = iConfig.getParameter<double>("relativeJetIsolationCut");
+  config_.switchOffTauIso = iConfig.getParameter<double>("switchOffTauIso");
+  config_.egLSB = iConfig.getParameter<double>("egammaLSB");
+  config_.regionLSB = iConfig.getParameter<double>("regionLSB");
+  config_.jetSF = iConfig.getParameter<vector<double> >("jetSF");
+  config_.deriveConstants();
+  if(fuseRegionCorrection_) {
+    std::shared_ptr<UCTRegionCorrectionTable> table(new UCTRegionCorrectionTable);
+    string error;
+    if(!table->build(iConfig.getParameter<vector<double> >("regionSF"),
+		     iConfig.getParameter<vector<double> >("regionSubtraction"),
+		     applyRegionCalibration_, true, &error))
+      throw cms::Exception("Configuration") << "UCT2015Producer: " << error;
+    config_.regionCorrection = table;
+  }
+  currentCalibration_.reset(new UCT2015Calibration);
+  currentCalibration_->config.reset(new uctcore::Config(config_));
+  currentCalibration_->checksum = 0;
+
+  string calibrationFile = iConfig.getParameter<string>("calibrationFile");
+  if(!calibrationFile.empty()) {
+    jetSFTable_ = iConfig.getParameter<string>("jetSFTable");
+    if(fuseRegionCorrection_) {
+      regionSFTable_ = iConfig.getParameter<string>("regionSFTable");
+      regionSubtractionTable_ = iConfig.getParameter<string>("regionSubtractionTable");
+    }
+    calibration_.reset(new uctcalib::Watcher(calibrationFile));
+    produces<unsigned int, edm::InLumi>("CalibrationChecksum");
+    string error;
+    if(!updateCalibration(&error))
+      throw cms::Exception("Configuration") << "UCT2015Producer: " << error;
+  }
+
+  for(int i = 0; i < N_STAGES; ++i)
+    stageCount_[i] = 0;
 
-  puLevelHI = 0;
-  puLevelHIUIC = 0.0;
-  puLevelHIHI.resize(L1CaloRegionDetId::N_ETA);
-  for(unsigned i = 0; i < L1CaloRegionDetId::N_ETA; ++i)
-    puLevelHIHI[i] = 0;
+  edm::InputTag uctDigis = iConfig.getParameter<edm::InputTag>("uctDigisTag");
+  if(puMultCorrect && !fuseRegionCorrection_) {
+    regionToken_ = consumes<L1CaloRegionCollection>(edm::InputTag("CorrectedDigis","CorrectedRegions"));
+    puLevelPUM0Token_ = consumes<int>(edm::InputTag("CorrectedDigis","PUM0Level"));
+  }
+  else {regionToken_ = consumes<L1CaloRegionCollection>(uctDigis);}
+  emCandToken_ = consumes<L1CaloEmCollection>(uctDigis);
+
+  // Only the outputs listed in outputCollections (all if it is empty) are
+  // produced, and only the stages needed for them are run.
+  vector<string> wanted = iConfig.getParameter<vector<string> >("outputCollections");
+  std::fill(produced_, produced_ + N_COLLECTIONS, wanted.empty());
+  for(unsigned int i = 0; i < wanted.size(); ++i) {
+    unsigned int c = 0;
+    while(c < N_COLLECTIONS && wanted[i] != outputs[c].name) ++c;
+    if(c == N_COLLECTIONS)
+      throw cms::Exception("Configuration") << "UCT2015Producer: unknown"
+	<< " output collection " << wanted[i] << " in outputCollections";
+    produced_[c] = true;
+  }
+  stages_ = (1u << N_STAGES) - 1;
+  if(!fuseRegionCorrection_) stages_ &= ~(1u << kRegionCorrection);
+  outputStages_ = 0;
+  if(produceCorrectedRegions_) {
+    outputStages_ |= 1u << kRegionCorrection;
+    produces<L1CaloRegionCollection>("CorrectedRegions");
+    produces<int>("PUM0Level");
+  }
 
   // Also declare we produce unpacked collections (which have more info)
-  produces<UCTCandidateCollection>( "JetUnpacked" ) ;
-  produces<UCTCandidateCollection>( "CorrJetUnpacked" ) ;
-  produces<UCTCandidateCollection>( "RelaxedEGUnpacked" ) ;
-  produces<UCTCandidateCollection>( "IsolatedEGUnpacked" ) ;
-  produces<UCTCandidateCollection>( "RelaxedTauUnpacked" ) ;
-  produces<UCTCandidateCollection>( "IsolatedTauUnpacked" ) ;
-  produces<UCTCandidateCollection>( "CorrRelaxedTauUnpacked" ) ;
-  produces<UCTCandidateCollection>( "CorrIsolatedTauUnpacked" ) ;
-  produces<UCTCandidateCollection>( "RelaxedTauEcalSeedUnpacked" ) ;
-  produces<UCTCandidateCollection>( "IsolatedTauEcalSeedUnpacked" ) ;
-  produces<UCTCandidateCollection>( "PULevelPUM0Unpacked" ) ;
-  produces<UCTCandidateCollection>( "PULevelUnpacked" ) ;
-  produces<UCTCandidateCollection>( "PULevelUICUnpacked" ) ;
-  produces<UCTCandidateCollection>( "METUnpacked" ) ;
-  produces<UCTCandidateCollection>( "MHTUnpacked" ) ;
-  produces<UCTCandidateCollection>( "SETUnpacked" ) ;
-  produces<UCTCandidateCollection>( "SHTUnpacked" ) ;
-
-  //now do what ever initialization is needed
-  for(unsigned int i = 0; i < L1CaloRegionDetId::N_PHI; i++) {
-    sinPhi.push_back(sin(2. * 3.1415927 * i * 1.0 / L1CaloRegionDetId::N_PHI));
-    cosPhi.push_back(cos(2. * 3.1415927 * i * 1.0 / L1CaloRegionDetId::N_PHI));
+  for(unsigned int i = 0; i < N_COLLECTIONS; ++i) {
+    if(!produced_[i]) continue;
+    if(outputs[i].stage != N_STAGES) outputStages_ |= 1u << outputs[i].stage;
+    produces<UCTCandidateCollection>(outputs[i].name);
+    if(produceCandidateTables_)
+      produces<UCTCandidateTable>(outputs[i].name);
   }
+  outputStages_ &= stages_;
 }
 
 
 // For the single objects, like MET/MHT, etc, convert them into a
 // std::auto_ptr<UCTCandidateCollection> suitable for putting into the edm::Event
 // The "collection" contains only 1 object.
-UCT2015Producer::UCTCandidateCollectionPtr collectionize(const UCTCandidate& obj) {
-  return UCT2015Producer::UCTCandidateCollectionPtr(
-						    new UCT2015Producer::UCTCandidateCollection(1, obj));
+UCT2015Producer::UCTCandidateCollectionPtr collectionize(const uctcore::Candidate& obj) {
+  UCT2015Producer::UCTCandidateCollectionPtr cands(new UCT2015Producer::UCTCandidateCollection);
+  cands->reserve(1);
+  uctcore::appendUCTCandidate(obj, cands.get());
+  return cands;
 }
 
-// ------------ method called for each event  ------------
-void
-UCT2015Producer::produce(edm::Event& iEvent, const edm::EventSetup& iSetup)
-{
-
-  puLevelPUM0=-1;
-
-  if(puMultCorrect) {
-    edm::Handle<int> puweightHandle;
-    iEvent.getByLabel("CorrectedDigis","CorrectedRegions", newRegions);
-    iEvent.getByLabel("CorrectedDigis","PUM0Level",puweightHandle);
-    puLevelPUM0=(*puweightHandle);
-  }
-  else {iEvent.getByLabel("uctDigis", newRegions);}
-  iEvent.getByLabel("uctDigis", newEMCands);
-
-  if(puCorrectHI) puSubtraction();
-
-  makeSums();
-  makeEGTaus();
-  // make sums and jets 0
-  makeSums();
-  makeJets();
-  //corrected Jet and Tau collections
-  corrJetList = correctJets(jetList,true);
-  // electrons and taus 
-  makeEGTaus();
-  makeTaus();
-  // nobody uses these
-  //corrRlxTauList = correctJets(rlxTauList,false);
-  //corrIsoTauList = correctJets(isoTauList,false);
-
-
-  UCTCandidateCollectionPtr unpackedJets(new UCTCandidateCollection);
-  UCTCandidateCollectionPtr unpackedRlxTaus(new UCTCandidateCollection);
-  UCTCandidateCollectionPtr unpackedIsoTaus(new UCTCandidateCollection);
-  UCTCandidateCollectionPtr unpackedCorrJets(new UCTCandidateCollection);
-  UCTCandidateCollectionPtr unpackedCorrRlxTaus(new UCTCandidateCollection);
-  UCTCandidateCollectionPtr unpackedCorrIsoTaus(new UCTCandidateCollection);
-  UCTCandidateCollectionPtr unpackedRlxEGs(new UCTCandidateCollection);
-  UCTCandidateCollectionPtr unpackedIsoEGs(new UCTCandidateCollection);
-  UCTCandidateCollectionPtr unpackedRlxTauRegionOnlys(new UCTCandidateCollection);
-  UCTCandidateCollectionPtr unpackedIsoTauRegionOnlys(new UCTCandidateCollection);
-
-  //uncorrected Jet and Tau collections
-  for(list<UCTCandidate>::iterator jet = jetList.begin();
-      jet != jetList.end();
-      jet++) {
-    unpackedJets->push_back(*jet);
-  }
-  for(list<UCTCandidate>::iterator rlxTau = rlxTauList.begin();
-      rlxTau != rlxTauList.end();
-      rlxTau++) {
-    unpackedRlxTaus->push_back(*rlxTau);
-  }
-  for(list<UCTCandidate>::iterator isoTau = isoTauList.begin();
-      isoTau != isoTauList.end();
-      isoTau++) {
-    unpackedIsoTaus->push_back(*isoTau);
-  }
-  for(list<UCTCandidate>::iterator jet = corrJetList.begin();
-      jet != corrJetList.end();
-      jet++) {
-    unpackedCorrJets->push_back(*jet);
-  }
-  /*
-    for(list<UCTCandidate>::iterator rlxTau = corrRlxTauList.begin();
-    rlxTau != corrRlxTauList.end();
-    rlxTau++) {
-    unpackedCorrRlxTaus->push_back(*rlxTau);
-    }
-    for(list<UCTCandidate>::iterator isoTau = corrIsoTauList.begin();
-    isoTau != corrIsoTauList.end();
-    isoTau++) {
-    unpackedCorrIsoTaus->push_back(*isoTau);
-    }
-  */
-  for(list<UCTCandidate>::iterator rlxTauRegionOnly = rlxTauRegionOnlyList.begin();
-      rlxTauRegionOnly != rlxTauRegionOnlyList.end();
-      rlxTauRegionOnly++) {
-    unpackedRlxTauRegionOnlys->push_back(*rlxTauRegionOnly);
-  }
-  for(list<UCTCandidate>::iterator isoTauRegionOnly = isoTauRegionOnlyList.begin();
-      isoTauRegionOnly != isoTauRegionOnlyList.end();
-      isoTauRegionOnly++) {
-    unpackedIsoTauRegionOnlys->push_back(*isoTauRegionOnly);
-  }
-
-  // egamma collections
-  for(list<UCTCandidate>::iterator rlxEG = rlxEGList.begin();
-      rlxEG != rlxEGList.end();
-      rlxEG++) {
-    unpackedRlxEGs->push_back(*rlxEG);
-  }
-  for(list<UCTCandidate>::iterator isoEG = isoEGList.begin();
-      isoEG != isoEGList.end();
-      isoEG++) {
-    unpackedIsoEGs->push_back(*isoEG);
+void UCT2015Producer::putCollection(edm::Event& iEvent,
+				    UCTCandidateCollectionPtr cands,
+				    const char* instance) const {
+  if(produceCandidateTables_) {
+    std::auto_ptr<UCTCandidateTable> table(new UCTCandidateTable(*cands));
+    iEvent.put(table, instance);
   }
+  iEvent.put(cands, instance);
+}
 
-  // Just store these as cands to make life easier.
-  UCTCandidate puLevelHIAsCand(puLevelHI, 0, 0);
-  UCTCandidate puLevelHIUICAsCand(puLevelHI, 0, 0);
-  UCTCandidate puLevelPUM0AsCand(puLevelPUM0, 0, 0);
-
-
-  iEvent.put(collectionize(puLevelPUM0AsCand), "PULevelPUM0Unpacked");
-  iEvent.put(collectionize(puLevelHIAsCand), "PULevelUnpacked");
-  iEvent.put(collectionize(puLevelHIUICAsCand), "PULevelUICUnpacked");
-  iEvent.put(collectionize(METObject), "METUnpacked");
-  iEvent.put(collectionize(MHTObject), "MHTUnpacked");
-  iEvent.put(collectionize(SETObject), "SETUnpacked");
-  iEvent.put(collectionize(SHTObject), "SHTUnpacked");
-
-  iEvent.put(unpackedJets, "JetUnpacked");
-  iEvent.put(unpackedRlxTaus, "RelaxedTauEcalSeedUnpacked");
-  iEvent.put(unpackedIsoTaus, "IsolatedTauEcalSeedUnpacked");
-  iEvent.put(unpackedCorrJets, "CorrJetUnpacked");
-  iEvent.put(unpackedCorrRlxTaus, "CorrRelaxedTauUnpacked");
-  iEvent.put(unpackedCorrIsoTaus, "CorrIsolatedTauUnpacked");
-  iEvent.put(unpackedRlxEGs, "RelaxedEGUnpacked");
-  iEvent.put(unpackedIsoEGs, "IsolatedEGUnpacked");
-  iEvent.put(unpackedRlxTauRegionOnlys, "RelaxedTauUnpacked");
-  iEvent.put(unpackedIsoTauRegionOnlys, "IsolatedTauUnpacked");
+void UCT2015Producer::putOutput(edm::Event& iEvent, Collection output,
+				const uctcore::Candidate& obj) const {
+  if(produced_[output])
+    putCollection(iEvent, collectionize(obj), outputs[output].name);
 }
 
-// NB PU is not in the physical scale!!  Needs to be multiplied by regionLSB
-/*void UCT2015Producer::puMultSubtraction()
-  {
-  puMult = 0;
-  for(L1CaloRegionCollection::const_iterator newRegion =
-  newRegions->begin();
-  newRegion != newRegions->end(); newRegion++){
-  double regionET =  regionPhysicalEt(*newRegion);
-  // cout << "regionET: " << regionET <<endl; 
-  if (regionET > 0) {puMult++;}
+void UCT2015Producer::putOutput(edm::Event& iEvent, Collection output,
+				uctcore::CandidateBuffer& buffer) const {
+  if(produced_[output]) {
+    // Each candidate of the buffer is converted once, straight into an
+    // exactly sized collection which is handed to the event as it is.  The
+    // stages work on uctcore::Candidate, not UCTCandidate, so this is the
+    // one copy left.  The buffer keeps its storage for the next event
+    // unless it comes from the arena.
+    UCTCandidateCollectionPtr cands(new UCTCandidateCollection);
+    cands->reserve(buffer.size());
+    for(uctcore::CandidateVector::const_iterator cand = buffer.begin();
+	cand != buffer.end(); ++cand)
+      uctcore::appendUCTCandidate(*cand, cands.get());
+    putCollection(iEvent, cands, outputs[output].name);
   }
+  buffer.discard();
+}
 
-  for(L1CaloRegionCollection::const_iterator newRegion =
-  newRegions->begin();
-  newRegion != newRegions->end(); newRegion++){
-  double regionET =  regionPhysicalEt(*newRegion);
-  // cout << "regionET: " << regionET <<endl; 
-  //the divide by regionLSB to get back to gct Digis
-  double regionEtCorr = (pumcorr(regionET, newRegion->gctEta(),puMult))/regionLSB_;
-  //		newRegion->et()=region;    
-  }
+void UCT2015Producer::putCorrectedRegions(edm::Event& iEvent,
+					  const L1CaloRegionCollection& regions,
+					  const uctcore::EventState& state) const {
+  std::auto_ptr<L1CaloRegionCollection> correctedRegions(new L1CaloRegionCollection);
+  correctedRegions->reserve(regions.size());
+  for(unsigned int i = 0; i < regions.size(); ++i)
+    correctedRegions->push_back(uctcore::makeCorrectedL1CaloRegion(regions[i], state.regionEtCorr[i]));
+  std::auto_ptr<int> pum0Level(new int(state.puLevelPUM0));
+  iEvent.put(correctedRegions, "CorrectedRegions");
+  iEvent.put(pum0Level, "PUM0Level");
+}
 
+std::unique_ptr<UCT2015EventContext>
+UCT2015Producer::beginStream(edm::StreamID) const {
+  return std::unique_ptr<UCT2015EventContext>(new UCT2015EventContext(useEventArena_));
+}
 
+bool UCT2015Producer::updateCalibration(std::string* error) const {
+  std::shared_ptr<const uctcalib::File> file = calibration_->update(error);
+  if(!file) return error->empty();
+  std::shared_ptr<uctcore::Config> config(new uctcore::Config(config_));
+  if(!file->get(jetSFTable_, &config->jetSF)) {
+    *error = file->fileName() + " has no table " + jetSFTable_;
+    return false;
   }
-*/
-
-void UCT2015Producer::puSubtraction()
-{
-  puLevelHI = 0;
-  puLevelHIUIC = 0;
-  double r_puLevelHIUIC=0.0;
-  double r_puLevelHIHI[L1CaloRegionDetId::N_ETA];
-
-  int etaCount[L1CaloRegionDetId::N_ETA];
-  for(unsigned i = 0; i < L1CaloRegionDetId::N_ETA; ++i)
-    {
-      puLevelHIHI[i] = 0;
-      r_puLevelHIHI[i] = 0.0;
-      etaCount[i] = 0;
+  config->deriveConstants();
+  if(fuseRegionCorrection_) {
+    vector<double> regionSF, regionSubtraction;
+    if(!file->get(regionSFTable_, &regionSF) ||
+       !file->get(regionSubtractionTable_, &regionSubtraction)) {
+      *error = file->fileName() + " has no table " + regionSFTable_ +
+	" or " + regionSubtractionTable_;
+      return false;
     }
-
-  int puCount = 0;
-  double Rarea=0.0;
-  for(L1CaloRegionCollection::const_iterator newRegion =
-	newRegions->begin();
-      newRegion != newRegions->end(); newRegion++){
-    if(regionPhysicalEt(*newRegion) <= puETMax) {
-      puLevelHI += newRegion->et(); puCount++;
-      r_puLevelHIUIC += newRegion->et();
-      Rarea += getRegionArea(newRegion->gctEta());
-    }
-    r_puLevelHIHI[newRegion->gctEta()] += newRegion->et();
-    etaCount[newRegion->gctEta()]++;
-    // cout << "regionET: " << regionET <<endl; 
-
-  } //end regionforloop
-  // Add a factor of 9, so it corresponds to a jet.  Reduces roundoff error.
-  puLevelHI *= 9;
-  if(puCount != 0) puLevelHI = puLevelHI / puCount;
-  r_puLevelHIUIC = r_puLevelHIUIC / Rarea;
-  puLevelHIUIC=0;
-  if (r_puLevelHIUIC > 0.) puLevelHIUIC = floor (r_puLevelHIUIC + 0.5);
-
-  for(unsigned i = 0; i < L1CaloRegionDetId::N_ETA; ++i)
-    {
-      puLevelHIHI[i] = floor(r_puLevelHIHI[i]/etaCount[i] + 0.5);
+    std::shared_ptr<UCTRegionCorrectionTable> table(new UCTRegionCorrectionTable);
+    if(!table->build(regionSF, regionSubtraction, applyRegionCalibration_, true, error)) {
+      *error = file->fileName() + ": " + *error;
+      return false;
     }
+    config->regionCorrection = table;
+  }
+  std::shared_ptr<UCT2015Calibration> calibration(new UCT2015Calibration);
+  calibration->config = config;
+  calibration->checksum = file->checksum();
+  currentCalibration_ = calibration;
+  calibration_->accept(file);
+  edm::LogInfo("UCT2015Producer") << "Calibration read from " << file->fileName()
+				  << " (checksum " << std::hex << file->checksum() << ")";
+  return true;
 }
 
-void UCT2015Producer::makeSums()
-{
-  sumET = 0;
-  sumEx = 0;
-  sumEy = 0;
-  sumHT = 0;
-  sumHx = 0;
-  sumHy = 0;
-
-  for(L1CaloRegionCollection::const_iterator newRegion = newRegions->begin();
-      newRegion != newRegions->end(); newRegion++){
-    // Remove forward stuff
-    if (newRegion->gctEta() < minGctEtaForSums || newRegion->gctEta() > maxGctEtaForSums) {
-      continue;
-    }
-
-    double regionET =  regionPhysicalEt(*newRegion);     
-
-    /*
-      if(puCorrectHISums)    {
-      regionET = std::max(regionPhysicalEt(*newRegion) - puLevelHI*regionLSB_/9., 0.);
-      }
-    */
- 
-    if(regionET >= regionETCutForMET){
-      sumET += regionET;
-      sumEx += (int) (((double) regionET) * cosPhi[newRegion->gctPhi()]);
-      sumEy += (int) (((double) regionET) * sinPhi[newRegion->gctPhi()]);
-    }
-    if(regionET >= regionETCutForHT) {
-      sumHT += regionET;
-      sumHx += (int) (((double) regionET) * cosPhi[newRegion->gctPhi()]);
-      sumHy += (int) (((double) regionET) * sinPhi[newRegion->gctPhi()]);
-    }
-    else if(regionET >= regionETCutForNeighbor) {
-      bool goodNeighbor = false;
-      for(L1CaloRegionCollection::const_iterator neighbor = newRegions->begin();
-	  neighbor != newRegions->end(); neighbor++) {
-	if((deltaGctPhi(*newRegion, *neighbor) == 1 && (newRegion->gctEta() == neighbor->gctEta())) ||
-	   (deltaGctPhi(*newRegion, *neighbor) == -1 && (newRegion->gctEta() == neighbor->gctEta())) ||
-	   (deltaGctPhi(*newRegion, *neighbor) == 0 && (newRegion->gctEta() - neighbor->gctEta()) == 1) ||
-	   (deltaGctPhi(*newRegion, *neighbor) == 0 && (neighbor->gctEta() - newRegion->gctEta()) == 1)) {
-	  double neighborET = regionPhysicalEt(*neighbor);
-	  if(neighborET >= regionETCutForHT) {
-	    goodNeighbor = true;
-	  }
-	}
-      }
-      if(goodNeighbor ) {
-	sumHT += regionET;
-	sumHx += (int) (((double) regionET) * cosPhi[newRegion->gctPhi()]);
-	sumHy += (int) (((double) regionET) * sinPhi[newRegion->gctPhi()]);
-      }
-    }
+std::shared_ptr<UCT2015Calibration>
+UCT2015Producer::globalBeginLuminosityBlock(const edm::LuminosityBlock&,
+					    const edm::EventSetup&) const {
+  std::lock_guard<std::mutex> lock(calibrationMutex_);
+  if(calibration_) {
+    string error;
+    if(!updateCalibration(&error))
+      edm::LogWarning("UCT2015Producer") << error << ", keeping the previous calibration";
   }
-  MET = ((unsigned int) sqrt(sumEx * sumEx + sumEy * sumEy));
-  MHT = ((unsigned int) sqrt(sumHx * sumHx + sumHy * sumHy));
-
-  double physicalPhi = atan2(sumEy, sumEx) + 3.1415927;
-  unsigned int iPhi = L1CaloRegionDetId::N_PHI * physicalPhi / (2 * 3.1415927);
-  METObject = UCTCandidate(MET, 0, physicalPhi);
-  METObject.setInt("rgnPhi", iPhi);
-  METObject.setInt("rank", MET);
-
-  double physicalPhiHT = atan2(sumHy, sumHx) + 3.1415927;
-  iPhi = L1CaloRegionDetId::N_PHI * (physicalPhiHT) / (2 * 3.1415927);
-  MHTObject = UCTCandidate(MHT, 0, physicalPhiHT);
-  MHTObject.setInt("rgnPhi", iPhi);
-  MHTObject.setInt("rank", MHT);
-
-  SETObject = UCTCandidate(sumET, 0, 0);
-  SETObject.setInt("rank", sumET);
-
-  SHTObject = UCTCandidate(sumHT, 0, 0);
-  SHTObject.setInt("rank", sumHT);
-
+  return currentCalibration_;
 }
 
-void UCT2015Producer::makeJets() {
-  jetList.clear();
-  for(L1CaloRegionCollection::const_iterator newRegion = newRegions->begin();
-      newRegion != newRegions->end(); newRegion++) {
-    double regionET = regionPhysicalEt(*newRegion);
-    if(puCorrectHI && useHI)
-      regionET = std::max(0.,regionET -
-			  (puLevelHIHI[newRegion->gctEta()]*regionLSB_));
-    if((regionET > jetSeed) || (puCorrectHI && useHI)) {
-      double neighborN_et = 0;
-      double neighborS_et = 0;
-      double neighborE_et = 0;
-      double neighborW_et = 0;
-      double neighborNE_et = 0;
-      double neighborSW_et = 0;
-      double neighborNW_et = 0;
-      double neighborSE_et = 0;
-      unsigned int nNeighbors = 0;
-      for(L1CaloRegionCollection::const_iterator neighbor = newRegions->begin();
-	  neighbor != newRegions->end(); neighbor++) {
-	double neighborET = regionPhysicalEt(*neighbor);
-	if(deltaGctPhi(*newRegion, *neighbor) == 1 &&
-	   (newRegion->gctEta()    ) == neighbor->gctEta()) {
-	  neighborN_et = neighborET;
-	  if(puCorrectHI && useHI)
-	    neighborN_et = std::max(0.,neighborET -
-				    (puLevelHIHI[neighbor->gctEta()]*regionLSB_));
-	  nNeighbors++; 
-	  //	std::cout<<"here neighborsN"<<endl;
-	  continue;
-	}
-	else if(deltaGctPhi(*newRegion, *neighbor) == -1 &&
-		(newRegion->gctEta()    ) == neighbor->gctEta()) {
-	  neighborS_et = neighborET;
-	  if(puCorrectHI && useHI)
-	    neighborS_et = std::max(0.,neighborET -
-				    (puLevelHIHI[neighbor->gctEta()]*regionLSB_));
-	  nNeighbors++;
-	  continue;
-	}
-	else if(deltaGctPhi(*newRegion, *neighbor) == 0 &&
-		(newRegion->gctEta() + 1) == neighbor->gctEta()) {
-	  neighborE_et = neighborET;
-	  if(puCorrectHI && useHI)
-	    neighborE_et = std::max(0.,neighborET -
-				    (puLevelHIHI[neighbor->gctEta()]*regionLSB_));
-	  nNeighbors++;
-	  continue;
-	}
-	else if(deltaGctPhi(*newRegion, *neighbor) == 0 &&
-		(newRegion->gctEta() - 1) == neighbor->gctEta()) {
-	  neighborW_et = neighborET;
-	  if(puCorrectHI && useHI)
-	    neighborW_et = std::max(0.,neighborET -
-				    (puLevelHIHI[neighbor->gctEta()]*regionLSB_));
-	  nNeighbors++;
-	  continue;
-	}
-	else if(deltaGctPhi(*newRegion, *neighbor) == 1 &&
-		(newRegion->gctEta() + 1) == neighbor->gctEta()) {
-	  neighborNE_et = neighborET;
-	  if(puCorrectHI && useHI)
-	    neighborNE_et = std::max(0.,neighborET -
-				     (puLevelHIHI[neighbor->gctEta()]*regionLSB_));
-	  nNeighbors++;
-	  continue;
-	}
-	else if(deltaGctPhi(*newRegion, *neighbor) == -1 &&
-		(newRegion->gctEta() - 1) == neighbor->gctEta()) {
-	  neighborSW_et = neighborET;
-	  if(puCorrectHI && useHI)
-	    neighborSW_et = std::max(0.,neighborET -
-				     (puLevelHIHI[neighbor->gctEta()]*regionLSB_));
-	  nNeighbors++;
-	  continue;
-	}
-	else if(deltaGctPhi(*newRegion, *neighbor) == 1 &&
-		(newRegion->gctEta() - 1) == neighbor->gctEta()) {
-	  neighborNW_et = neighborET;
-	  if(puCorrectHI && useHI)
-	    neighborNW_et = std::max(0.,neighborET -
-				     (puLevelHIHI[neighbor->gctEta()]*regionLSB_));
-	  nNeighbors++;
-	  continue;
-	}
-	else if(deltaGctPhi(*newRegion, *neighbor) == -1 &&
-		(newRegion->gctEta() + 1) == neighbor->gctEta()) {
-	  neighborSE_et = neighborET;
-	  if(puCorrectHI && useHI)
-	    neighborSE_et = std::max(0.,neighborET -
-				     (puLevelHIHI[neighbor->gctEta()]*regionLSB_));
-	  nNeighbors++;
-	  continue;
-	}
-      }
-      if(regionET > neighborN_et &&
-	 regionET > neighborNW_et &&
-	 regionET > neighborW_et &&
-	 regionET > neighborSW_et &&
-	 regionET >= neighborNE_et &&
-	 regionET >= neighborE_et &&
-	 regionET >= neighborSE_et &&
-	 regionET >= neighborS_et) {
-	unsigned int jetET = regionET +
-	  neighborN_et + neighborS_et + neighborE_et + neighborW_et +
-	  neighborNE_et + neighborSW_et + neighborSE_et + neighborNW_et;
-
-	/*std::cout<<"FOUND JET!   " <<regionET<<std::endl;
-	  std::cout<<"\t  "<<neighborNW_et<<"  "<<neighborN_et<<"   "<<neighborNE_et<<std::endl;
-	  std::cout<<"\t  "<<neighborW_et<<"  "<<regionET<<"   "<<neighborE_et<<std::endl;
-	  std::cout<<"\t  "<<neighborSW_et<<"  "<<neighborS_et<<"   "<<neighborSE_et<<std::endl;
-	*/
-
-	/*
-	  int jetPhi = newRegion->gctPhi() * 4 +
-	  ( - 2 * (neighborS_et + neighborSE_et + neighborSW_et)
-	  + 2 * (neighborN_et + neighborNE_et + neighborNW_et) ) / jetET;
-	  if(jetPhi < 0) {
-
-	  }
-	  else if(jetPhi >= ((int) N_JET_PHI)) {
-	  jetPhi -= N_JET_PHI;
-	  }
-	  int jetEta = newRegion->gctEta() * 4 +
-	  ( - 2 * (neighborW_et + neighborNW_et + neighborSW_et)
-	  + 2 * (neighborE_et + neighborNE_et + neighborSE_et) ) / jetET;
-	  if(jetEta < 0) jetEta = 0;
-	  if(jetEta >= ((int) N_JET_ETA)) jetEta = N_JET_ETA - 1;
-	*/
-	// Temporarily use the region granularity -- we will try to improve as above when code is debugged
-	int jetPhi = newRegion->gctPhi();
-	int jetEta = newRegion->gctEta();
-
-	bool neighborCheck = (nNeighbors == 8);
-	// On the eta edge we only expect 5 neighbors
-	if (!neighborCheck && (jetEta == 0 || jetEta == 21) && nNeighbors == 5)
-	  neighborCheck = true;
-
-	if (!neighborCheck) {
-	  std::cout << "phi: " << jetPhi << " eta: " << jetEta << " n: " << nNeighbors << std::endl;
-	  std::cout << "JetPt: " << jetET << " regionET: " << regionET << std::endl;
-	  assert(false);
-	}
-	UCTCandidate theJet(jetET, convertRegionEta(jetEta), convertRegionPhi(jetPhi));
-	theJet.setInt("rgnEta", jetEta);
-	theJet.setInt("rgnPhi", jetPhi);
-	theJet.setInt("rctEta",  newRegion->rctEta());
-	theJet.setInt("rctPhi", newRegion->rctPhi());
-	theJet.setInt("rank", jetET);
-
-	theJet.setInt("neighborNW_et", neighborNW_et);
-	theJet.setInt("neighborW_et", neighborW_et);
-	theJet.setInt("neighborSW_et", neighborSW_et);
-	theJet.setInt("neighborNE_et", neighborNE_et);
-	theJet.setInt("neighborE_et", neighborE_et);
-	theJet.setInt("neighborSW_et", neighborSW_et); 
-	theJet.setInt("neighborSE_et", neighborSE_et);
-	theJet.setInt("neighborN_et", neighborN_et);
-	theJet.setInt("neighborS_et", neighborS_et);
-	theJet.setInt("jetseed_et", regionET);
-
-	// Embed the puLevelHI information in the jet object for later tuning
-	theJet.setFloat("puLevelPUM0",puLevelPUM0);
-	theJet.setFloat("puLevelHI", puLevelHI);
-	theJet.setFloat("puLevelHIUIC", puLevelHIUIC);
-	// Store information about the "core" PT of the jet (central region)
-	theJet.setFloat("associatedRegionEt", regionET);
-	jetList.push_back(theJet);
-      }
-    }
-  }
-  jetList.sort();
-  jetList.reverse();
+void
+UCT2015Producer::globalEndLuminosityBlockProduce(edm::LuminosityBlock& iLumi,
+						 const edm::EventSetup&) const {
+  if(!calibration_) return;
+  std::auto_ptr<unsigned int> checksum(
+      new unsigned int(luminosityBlockCache(iLumi.index())->checksum));
+  iLumi.put(checksum, "CalibrationChecksum");
 }
 
-list<UCTCandidate>
-UCT2015Producer::correctJets(const list<UCTCandidate>& jets, bool isJet) {
-  // jet corrections only valid if PU density has been calculated
-  list<UCTCandidate> corrlist;
-  if (!applyJetCalibration) {corrlist=jets; return corrlist;}
-
-  corrlist.clear();
-
-  for(list<UCTCandidate>::const_iterator jet = jets.begin(); jet != jets.end(); jet++) {
-
-    const double jetET=jet->pt();
-    double alpha = m_jetSF[2*jet->getInt("rgnEta") + 0]; //Scale factor (See jetSF_cfi.py)
-    double gamma = ((m_jetSF[2*jet->getInt("rgnEta") + 1])); //Offset
-
-    double jpt = jetET*alpha+gamma;
-    unsigned int corjetET =(int) jpt;
-
-    //                cout<<"JET :"<<jetET<<"    "<<jet->getInt("rgnEta")<<"    "<<alpha<<"   "<<gamma<<"    -->"<<jpt<<endl;
-
-    UCTCandidate newJet(corjetET, convertRegionEta(jet->getInt("rgnEta")), convertRegionPhi(jet->getInt("rgnPhi")));
-    newJet.setFloat("uncorrectedPt", jetET);
-    newJet.setInt("rgnEta", jet->getInt("rgnEta"));
-    newJet.setInt("rgnPhi", jet->getInt("rgnPhi"));
-    newJet.setInt("rctEta", jet->getInt("rctEta"));
-    newJet.setInt("rctPhi", jet->getInt("rctPhi"));
-    newJet.setInt("rank", corjetET);
-
-    if(isJet){
-      newJet.setInt("jetseed_et", jet->getInt("jetseed_et"));
-      newJet.setInt("neighborNW_et", jet->getInt("neighborNW_et"));
-      newJet.setInt("neighborN_et", jet->getInt("neighborN_et"));
-      newJet.setInt("neighborNE_et", jet->getInt("neighborNE_et"));
-      newJet.setInt("neighborW_et", jet->getInt("neighborW_et"));
-      newJet.setInt("neighborE_et", jet->getInt("neighborE_et"));
-      newJet.setInt("neighborSW_et", jet->getInt("neighborSW_et"));
-      newJet.setInt("neighborS_et", jet->getInt("neighborS_et"));
-      newJet.setInt("neighborSE_et", jet->getInt("neighborSE_et"));
-    }
-    newJet.setFloat("puLevelPUM0",puLevelPUM0);
-    newJet.setFloat("puLevelHI", puLevelHI);
-    newJet.setFloat("puLevelHIUIC", puLevelHIUIC);
+// ------------ method called for each event  ------------
+void
+UCT2015Producer::produce(edm::StreamID sid, edm::Event& iEvent,
+			 const edm::EventSetup& iSetup) const
+{
+  UCT2015EventContext& ctx = *streamCache(sid);
+  uctcore::EventState& state = ctx.state;
+  const uctcore::Config& config = *luminosityBlockCache(iEvent.getLuminosityBlock().index())->config;
 
-    corrlist.push_back(newJet);
-  }
+  state.puLevelPUM0=-1;
 
-  corrlist.sort();
-  corrlist.reverse();
-
-  return corrlist;
-}   // This is outdated now - check with MIT for HI
-
-// Given a region at iphi/ieta, find the highest region in the surrounding
-// regions.
-void UCT2015Producer::findAnnulusInfo(int ieta, int iphi,
-				      const L1CaloRegionCollection& regions,
-				      double* associatedSecondRegionEt,
-				      double* associatedThirdRegionEt,
-				      unsigned int* mipsInAnnulus,
-				      unsigned int* egFlagsInAnnulus,
-				      unsigned int* mipInSecondRegion) const {
-
-  unsigned int neighborsFound = 0;
-  unsigned int mipsCount = 0;
-  unsigned int egFlagCount = 0;
-  double highestNeighborEt = 0;
-  // We don't want to count the contribution of the highest neighbor, this allows
-  // us to subtract off the highest neighbor at the end, so we only loop once.
-  bool highestNeighborHasMip = false;
-  bool highestNeighborHasEGFlag = false;
-  double secondNeighborEt = 0;
-
-
-  for(L1CaloRegionCollection::const_iterator region = regions.begin();
-      region != regions.end(); region++) {
-    int regionPhi = region->gctPhi();
-    int regionEta = region->gctEta();
-    unsigned int deltaPhi = std::abs(deltaPhiWrapAtN(18, iphi, regionPhi));
-    unsigned int deltaEta = std::abs(ieta - regionEta);
-    if ((deltaPhi + deltaEta) > 0 && deltaPhi < 2 && deltaEta < 2) {
-      double regionET = regionPhysicalEt(*region);
-      if (regionET > highestNeighborEt) {
-	if(highestNeighborEt!=0) secondNeighborEt=highestNeighborEt;
-	highestNeighborEt = regionET;
-	// Keep track of what flags the highest neighbor has
-	highestNeighborHasMip = region->mip();
-	highestNeighborHasEGFlag = !region->mip() && !region->tauVeto();
-      }
-
-      // count how many neighbors pass the flags.
-      if (region->mip()) {
-	mipsCount++;
-      }
-      if (!region->mip() && !region->tauVeto()) {
-	egFlagCount++;
-      }
-
-      // If we already found all 8 neighbors, we don't need to keep looping
-      // over the regions.
-      neighborsFound++;
-      if (neighborsFound == 8) {
-	break;
-      }
-    }
+  Handle<L1CaloRegionCollection> newRegions;
+  Handle<L1CaloEmCollection> newEMCands;
+  iEvent.getByToken(regionToken_, newRegions);
+  if(puMultCorrect && !fuseRegionCorrection_) {
+    edm::Handle<int> puweightHandle;
+    iEvent.getByToken(puLevelPUM0Token_, puweightHandle);
+    state.puLevelPUM0=(*puweightHandle);
   }
-  // check if we need to remove the highest neighbor from the flag count.
-  if (highestNeighborHasMip)
-    mipsCount--;
-  if (highestNeighborHasEGFlag)
-    egFlagCount--;
-
-  // set output
-  *associatedSecondRegionEt = highestNeighborEt;
-  *associatedThirdRegionEt =secondNeighborEt;
-  *mipsInAnnulus = mipsCount;
-  *mipInSecondRegion = highestNeighborHasMip;
-  *egFlagsInAnnulus = egFlagCount;
-}
-
-void UCT2015Producer::makeEGTaus() {
-  rlxTauList.clear();
-  isoTauList.clear();
-  rlxEGList.clear();
-  isoEGList.clear();
-  for(L1CaloEmCollection::const_iterator egtCand =
-	newEMCands->begin();
-      egtCand != newEMCands->end(); egtCand++){
-    double et = egPhysicalEt(*egtCand);
-    if(et > egtSeed) {
-
-      for(L1CaloRegionCollection::const_iterator region = newRegions->begin();
-	  region != newRegions->end(); region++) {
-	if(egtCand->regionId().iphi() == region->gctPhi() &&
-	   egtCand->regionId().ieta() == region->gctEta())
-	  {
-	    double regionEt = regionPhysicalEt(*region);
-
-	    bool isEle=false;
-	    if(et<40 && (!region->tauVeto() && !region->mip() )) isEle=true;      
-	    if(et>=40 && et<63 && (!region->mip() )) isEle=true;
-	    if(et>=63) isEle=true;
-
-	    isEle=true;  // Lets rescue the old LUT
-
-	    // Find the highest region in the 3x3 annulus around the center
-	    // region.
-	    double associatedSecondRegionEt = 0;
-	    double associatedThirdRegionEt = 0;
-	    unsigned int mipsInAnnulus = 0;
-	    unsigned int egFlagsInAnnulus = 0;
-	    unsigned int mipInSecondRegion = 0;
-	    findAnnulusInfo(
-			    egtCand->regionId().ieta(), egtCand->regionId().iphi(),
-			    *newRegions,
-			    &associatedSecondRegionEt, &associatedThirdRegionEt, &mipsInAnnulus, &egFlagsInAnnulus,
-			    &mipInSecondRegion);
-
-	    UCTCandidate egtauCand(
-				   et,
-				   convertRegionEta(egtCand->regionId().ieta()),
-				   convertRegionPhi(egtCand->regionId().iphi()));
-
-	    /*            UCTCandidate tauCand(
-			  regionEt,
-			  convertRegionEta(egtCand->regionId().ieta()),
-			  convertRegionPhi(egtCand->regionId().iphi()));
-	    */
-
-
-	    // Add extra information to the candidate
-	    egtauCand.setInt("rgnEta", egtCand->regionId().ieta());
-	    egtauCand.setInt("rgnPhi", egtCand->regionId().iphi());
-	    egtauCand.setInt("rctEta", egtCand->regionId().rctEta());
-	    egtauCand.setInt("rctPhi", egtCand->regionId().rctPhi());
-	    egtauCand.setInt("rank", egtCand->rank());
-	    egtauCand.setFloat("associatedJetPt", -3);
-	    egtauCand.setFloat("associatedRegionEt", regionEt);
-	    egtauCand.setFloat("associatedSecondRegionEt", associatedSecondRegionEt);
-	    egtauCand.setInt("associatedSecondRegionMIP", mipInSecondRegion);
-	    egtauCand.setFloat("puLevelHI", puLevelHI);
-	    egtauCand.setFloat("puLevelHIUIC", puLevelHIUIC);
-	    egtauCand.setFloat("puLevelPUM0",puLevelPUM0);
-	    egtauCand.setInt("ellIsolation", egtCand->isolated());
-	    egtauCand.setInt("tauVeto", region->tauVeto());
-	    egtauCand.setInt("mipBit", region->mip());
-	    egtauCand.setInt("isEle", isEle);
-
-	    /*
-	      tauCand.setInt("rgnEta", egtCand->regionId().ieta());
-	      tauCand.setInt("rgnPhi", egtCand->regionId().iphi());
-	      tauCand.setInt("rctEta", egtCand->regionId().rctEta());
-	      tauCand.setInt("rctPhi", egtCand->regionId().rctPhi());
-	      tauCand.setFloat("associatedRegionEt", regionEt);
-	      tauCand.setFloat("associatedJetPt", -3);
-	      tauCand.setFloat("associatedSecondRegionEt", associatedSecondRegionEt);
-	      tauCand.setInt("associatedSecondRegionMIP", mipInSecondRegion);
-	      tauCand.setInt("tauVeto", region->tauVeto());
-	      tauCand.setInt("mipBit", region->mip());
-	    */
-
-
-	    // A 2x1 and 1x2 cluster above egtSeed is always in tau list
-	    rlxTauList.push_back(egtauCand);
-
-	    // Note tauVeto now refers to emActivity pattern veto;
-	    // Good patterns are from EG candidates
-	    if (isEle){
-	      rlxEGList.push_back(egtauCand);
-	    }
-
-	    // Look for overlapping jet and require that isolation be passed
-	    //                                          for(list<UCTCandidate>::iterator jet = corrJetList.begin(); jet != corrJetList.end(); jet++) { 
-	    bool MATCHEDJETFOUND_=false;        
-	    for(list<UCTCandidate>::iterator jet = jetList.begin(); jet != jetList.end(); jet++) {
-
-	      if((int)egtCand->regionId().iphi() == jet->getInt("rgnPhi") &&
-		 (int)egtCand->regionId().ieta() == jet->getInt("rgnEta")) {
-		// Embed tuning parameters into the relaxed objects
-		rlxTauList.back().setFloat("associatedJetPt", jet->pt());
-
-		MATCHEDJETFOUND_=true;
-
-		// EG ID enabled! MC
-		if (isEle){
-		  rlxEGList.back().setFloat("associatedJetPt", jet->pt());
-		  bool isHighPtEle=true;                      
-		  if(jet->pt()>2*regionEt) isHighPtEle=false;
-		  rlxEGList.back().setInt("isHighPtEle",isHighPtEle);
-		}
-
-
-		//                                                        cout<<"Electron? "<<et<<"   "<<jet->pt()<<"   "<<egtCand->regionId().ieta()<<endl;
-
-		double jetIsolation = jet->pt() - regionEt;        // Jet isolation
-		double relativeJetIsolation = jetIsolation / regionEt;
-		// A 2x1 and 1x2 cluster above egtSeed passing relative isolation will be in tau list
-		if(relativeJetIsolation < relativeTauIsolationCut || regionEt > switchOffTauIso){
-		  isoTauList.push_back(rlxTauList.back());
-		}
-		//double jetIsolationRegionEG = jet->pt()-regionEt;   // Core isolation (could go less than zero)
-		//double relativeJetIsolationRegionEG = jetIsolationRegionEG / regionEt;
-		double jetIsolationEG = jet->pt() - et;        // Jet isolation
-		double relativeJetIsolationEG = jetIsolationEG / et;
-
-		bool isolatedEG=false;
-		if(et<63 && relativeJetIsolationEG < relativeJetIsolationCut)  isolatedEG=true;; 
-		if (et>=63) isolatedEG=true;;
-                                                        
-		if(isEle){
-		  rlxEGList.back().setInt("isIsolated",isolatedEG);
-		  if(isolatedEG){
-		    isoEGList.push_back(rlxEGList.back());
-		  }
-		}
-		break;
-	      }
-	    }
-	    if(!MATCHEDJETFOUND_ && isEle) {
-	      rlxEGList.back().setFloat("associatedJetPt",-777);
-	      rlxEGList.back().setInt("isHighPtEle",true);        
-	      rlxEGList.back().setInt("isIsolated",true);
-	      isoEGList.push_back(rlxEGList.back());
-	    }
-	    break;
-	  }
-      }
-    }
+  iEvent.getByToken(emCandToken_, newEMCands);
+  uctcore::makeRegions(*newRegions, &state.regions);
+  uctcore::makeEmCands(*newEMCands, &state.emCands);
+
+  ++eventCount_;
+  ctx.stagesDone_ = 0;
+  for(int stage = 0; stage < N_STAGES; ++stage) {
+    if(outputStages_ & (1u << stage)) runStage(ctx, config, Stage(stage));
   }
-  rlxEGList.sort();
-  rlxTauList.sort();
-  isoEGList.sort();
-  isoTauList.sort();
-  rlxEGList.reverse();
-  rlxTauList.reverse();
-  isoEGList.reverse();
-  isoTauList.reverse();
 
+  // Just store these as cands to make life easier.
+  uctcore::Candidate puLevelHIAsCand(state.puLevelHI, 0, 0);
+  uctcore::Candidate puLevelHIUICAsCand(state.puLevelHI, 0, 0);
+  uctcore::Candidate puLevelPUM0AsCand(state.puLevelPUM0, 0, 0);
+
+
+  if(produceCorrectedRegions_) putCorrectedRegions(iEvent, *newRegions, state);
+  putOutput(iEvent, kPULevelPUM0Out, puLevelPUM0AsCand);
+  putOutput(iEvent, kPULevelOut, puLevelHIAsCand);
+  putOutput(iEvent, kPULevelUICOut, puLevelHIUICAsCand);
+  putOutput(iEvent, kMETOut, state.METObject);
+  putOutput(iEvent, kMHTOut, state.MHTObject);
+  putOutput(iEvent, kSETOut, state.SETObject);
+  putOutput(iEvent, kSHTOut, state.SHTObject);
+
+  putOutput(iEvent, kJetOut, state.jetList);
+  putOutput(iEvent, kRlxTauEcalSeedOut, state.rlxTauList);
+  putOutput(iEvent, kIsoTauEcalSeedOut, state.isoTauList);
+  putOutput(iEvent, kCorrJetOut, state.corrJetList);
+  putOutput(iEvent, kCorrRlxTauOut, state.corrRlxTauList);
+  putOutput(iEvent, kCorrIsoTauOut, state.corrIsoTauList);
+  putOutput(iEvent, kRlxEGOut, state.rlxEGList);
+  putOutput(iEvent, kIsoEGOut, state.isoEGList);
+  putOutput(iEvent, kRlxTauOut, state.rlxTauRegionOnlyList);
+  putOutput(iEvent, kIsoTauOut, state.isoTauRegionOnlyList);
+
+  // All the per-event candidate storage goes in one go.
+  state.eventArena.reset();
 }
 
-void UCT2015Producer::makeTaus() {
-  rlxTauRegionOnlyList.clear();
-  isoTauRegionOnlyList.clear();
-  for(L1CaloRegionCollection::const_iterator region = newRegions->begin();
-      region != newRegions->end(); region++) {
-    double regionEt = regionPhysicalEt(*region);
-    if(regionEt<tauSeed) continue;
-
-    double associatedSecondRegionEt = 0;
-    double associatedThirdRegionEt = 0;
-    unsigned int mipsInAnnulus = 0;
-    unsigned int egFlagsInAnnulus = 0;
-    unsigned int mipInSecondRegion = 0;
-    findAnnulusInfo(
-		    region->id().ieta(), region->id().iphi(),
-		    *newRegions,
-		    &associatedSecondRegionEt, &associatedThirdRegionEt,  &mipsInAnnulus, &egFlagsInAnnulus,
-		    &mipInSecondRegion);
-
-    double tauEt=regionEt;
-    //            if(associatedSecondRegionEt>tauSeed)  tauEt +=associatedSecondRegionEt;
-
-    UCTCandidate tauCand(
-			 tauEt,
-			 convertRegionEta(region->id().ieta()),    // this is wrong (should take into acount the neighbours and center the tau in the division
-			 convertRegionPhi(region->id().iphi()));   // also, two taus will appear! we need to remove one
-
-
-    tauCand.setInt("gctEta", region->gctEta());
-    tauCand.setInt("gctPhi", region->gctPhi());
-    tauCand.setInt("rgnEta", region->id().ieta());
-    tauCand.setInt("rgnPhi", region->id().iphi());
-    tauCand.setInt("rctEta", region->id().rctEta());
-    tauCand.setInt("rctPhi", region->id().rctPhi());
-    tauCand.setFloat("associatedJetPt", -3);
-    tauCand.setFloat("associatedRegionEt", regionEt);
-    tauCand.setFloat("puLevelHI", puLevelHI);
-    tauCand.setFloat("puLevelHIUIC", puLevelHIUIC);
-    tauCand.setFloat("puLevelPUM0",puLevelPUM0);
-    tauCand.setInt("tauVeto", region->tauVeto());
-    tauCand.setInt("mipBit", region->mip());
-    tauCand.setFloat("associatedSecondRegionEt", associatedSecondRegionEt);
-    tauCand.setInt("associatedSecondRegionMIP", mipInSecondRegion);
-    tauCand.setFloat("associatedThirdRegionEt", associatedThirdRegionEt);
-
-    rlxTauRegionOnlyList.push_back(tauCand);
-
-                        
-    bool MATCHEDJETFOUND_=false;
-    // Look for overlapping jet and require that isolation be passed
-    for(list<UCTCandidate>::iterator jet = jetList.begin(); jet != jetList.end(); jet++) {
-      //                                  for(list<UCTCandidate>::iterator jet = corrJetList.begin(); jet != corrJetList.end(); jet++) {      
-      if((int)region->gctPhi() == jet->getInt("rgnPhi") &&
-	 (int)region->gctEta() == jet->getInt("rgnEta")) {
-	MATCHEDJETFOUND_=true;
-	rlxTauRegionOnlyList.back().setFloat("associatedJetPt", jet->pt());
-
-	double jetIsolation = jet->pt() - regionEt;        // Jet isolation
-	double relativeJetIsolation = jetIsolation / regionEt;
-	if(relativeJetIsolation < relativeTauIsolationCut || regionEt > switchOffTauIso){
-	  isoTauRegionOnlyList.push_back(rlxTauRegionOnlyList.back());
-	}
-
-	break;
-      }
-    }
-    if(!MATCHEDJETFOUND_){ 
-      rlxTauRegionOnlyList.back().setFloat("associatedJetPt", -777);
-      isoTauRegionOnlyList.push_back(rlxTauRegionOnlyList.back());
-    }       
+void UCT2015Producer::runStage(UCT2015EventContext& ctx,
+			       const uctcore::Config& config, Stage stage) const {
+  if(ctx.stagesDone_ & (1u << stage)) return;
+  const StageNode& node = stageNodes[stage];
+  unsigned int inputs = node.inputs & stages_;
+  for(int input = 0; input < N_STAGES; ++input) {
+    if(inputs & (1u << input)) runStage(ctx, config, Stage(input));
   }
-  rlxTauRegionOnlyList.sort();
-  isoTauRegionOnlyList.sort();
-  rlxTauRegionOnlyList.reverse();
-  isoTauRegionOnlyList.reverse();
-
-
+  node.run(config, ctx.state);
+  ctx.stagesDone_ |= 1u << stage;
+  ++stageCount_[stage];
+}
 
+void UCT2015Producer::endJob() {
+  if(!reportStageCounts_) return;
+  edm::LogInfo log("UCT2015Producer");
+  log << "Stage executions in " << eventCount_.load() << " events:";
+  for(int i = 0; i < N_STAGES; ++i)
+    log << "\n  " << stageNodes[i].name << ": " << stageCount_[i].load();
 }
 
 
@@ -0,0 +1,88 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  UCTEventFileWriter.cc
+ *
+ *    Description:  Writes the RCT regions and EM candidates of every event
+ *                  to a UCTEventFile (see UCTEventFile.h), to be replayed
+ *                  later with UCTRecordedDigis.
+ *
+ * =====================================================================================
+ */
+
+#include <string>
+
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/one/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include "DataFormats/L1CaloTrigger/interface/L1CaloCollections.h"
+#include "DataFormats/L1CaloTrigger/interface/L1CaloRegion.h"
+#include "DataFormats/L1CaloTrigger/interface/L1CaloEmCand.h"
+
+#include "L1Trigger/UCT2015/interface/UCTEventFile.h"
+#include "L1Trigger/UCT2015/interface/UCTCoreAdapters.h"
+
+class UCTEventFileWriter : public edm::one::EDAnalyzer<> {
+  public:
+    explicit UCTEventFileWriter(const edm::ParameterSet& pset);
+    virtual void beginJob();
+    virtual void analyze(const edm::Event& evt, const edm::EventSetup& es);
+    virtual void endJob();
+  private:
+    std::string fileName_;
+    edm::EDGetTokenT<L1CaloRegionCollection> regionToken_;
+    edm::EDGetTokenT<L1CaloEmCollection> emCandToken_;
+    uctfile::Writer writer_;
+    uctfile::Record record_;
+};
+
+UCTEventFileWriter::UCTEventFileWriter(const edm::ParameterSet& pset) :
+  fileName_(pset.getParameter<std::string>("fileName")) {
+  edm::InputTag src = pset.getParameter<edm::InputTag>("src");
+  regionToken_ = consumes<L1CaloRegionCollection>(src);
+  emCandToken_ = consumes<L1CaloEmCollection>(src);
+}
+
+void UCTEventFileWriter::beginJob() {
+  std::string error;
+  if (!writer_.open(fileName_, &error))
+    throw cms::Exception("UCTEventFile") << error;
+}
+
+void UCTEventFileWriter::analyze(const edm::Event& evt, const edm::EventSetup& es) {
+  edm::Handle<L1CaloRegionCollection> regions;
+  edm::Handle<L1CaloEmCollection> emCands;
+  evt.getByToken(regionToken_, regions);
+  evt.getByToken(emCandToken_, emCands);
+
+  if (regions->size() > uctfile::MAX_REGIONS || emCands->size() > uctfile::MAX_EM_CANDS)
+    throw cms::Exception("UCTEventFile") << "Event " << evt.id() << " has "
+      << regions->size() << " regions and " << emCands->size()
+      << " EM candidates, more than a record holds";
+
+  record_.run = evt.id().run();
+  record_.lumi = evt.id().luminosityBlock();
+  record_.event = evt.id().event();
+  record_.nRegions = regions->size();
+  record_.nEmCands = emCands->size();
+  for (size_t i = 0; i < regions->size(); ++i)
+    record_.regions[i] = uctcore::makeRegionWord((*regions)[i]);
+  for (size_t i = 0; i < emCands->size(); ++i)
+    record_.emCands[i] = uctcore::makeEmCandWord((*emCands)[i]);
+
+  std::string error;
+  if (!writer_.write(record_, &error))
+    throw cms::Exception("UCTEventFile") << error;
+}
+
+void UCTEventFileWriter::endJob() {
+  std::string error;
+  if (!writer_.close(&error))
+    throw cms::Exception("UCTEventFile") << error;
+}
+
+DEFINE_FWK_MODULE(UCTEventFileWriter);
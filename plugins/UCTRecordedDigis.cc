@@ -0,0 +1,83 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  UCTRecordedDigis.cc
+ *
+ *    Description:  Puts the RCT regions and EM candidates of a UCTEventFile
+ *                  (see UCTEventFile.h) in the event, in place of uctDigis.
+ *                  Each event gets the record with its run, lumi and event
+ *                  number.  With replayInOrder set, for an EmptySource,
+ *                  event n gets record n - 1 instead, so the file can be
+ *                  replayed with any number of streams.
+ *
+ * =====================================================================================
+ */
+
+#include <memory>
+#include <string>
+
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/global/EDProducer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include "DataFormats/L1CaloTrigger/interface/L1CaloCollections.h"
+#include "DataFormats/L1CaloTrigger/interface/L1CaloRegion.h"
+#include "DataFormats/L1CaloTrigger/interface/L1CaloEmCand.h"
+
+#include "L1Trigger/UCT2015/interface/UCTEventFile.h"
+#include "L1Trigger/UCT2015/interface/UCTCoreAdapters.h"
+
+class UCTRecordedDigis : public edm::global::EDProducer<> {
+  public:
+    explicit UCTRecordedDigis(const edm::ParameterSet& pset);
+    virtual void produce(edm::StreamID, edm::Event& evt, const edm::EventSetup& es) const;
+  private:
+    bool replayInOrder_;
+    // Read-only once opened.
+    uctfile::Reader reader_;
+};
+
+UCTRecordedDigis::UCTRecordedDigis(const edm::ParameterSet& pset) :
+  replayInOrder_(pset.getUntrackedParameter<bool>("replayInOrder", false)) {
+  std::string fileName = pset.getParameter<std::string>("fileName");
+  std::string error;
+  if (!reader_.open(fileName, &error))
+    throw cms::Exception("UCTEventFile") << error;
+  produces<L1CaloRegionCollection>();
+  produces<L1CaloEmCollection>();
+}
+
+void UCTRecordedDigis::produce(edm::StreamID, edm::Event& evt, const edm::EventSetup& es) const {
+  uint64_t i;
+  if (replayInOrder_) {
+    i = evt.id().event() - 1;
+    if (evt.id().event() == 0 || i >= reader_.size())
+      throw cms::Exception("UCTEventFile") << "Event " << evt.id()
+        << " has no record, the file has " << reader_.size();
+  } else {
+    i = reader_.find(evt.id().run(), evt.id().luminosityBlock(), evt.id().event());
+    if (i == reader_.size())
+      throw cms::Exception("UCTEventFile") << "Event " << evt.id()
+        << " is not in the file";
+  }
+  // Reader::open has checked the counts and positions of every record.
+  const uctfile::Record& record = reader_.record(i);
+
+  std::auto_ptr<L1CaloRegionCollection> regions(new L1CaloRegionCollection);
+  regions->reserve(record.nRegions);
+  for (unsigned int r = 0; r < record.nRegions; ++r)
+    regions->push_back(uctcore::makeL1CaloRegion(record.regions[r]));
+
+  std::auto_ptr<L1CaloEmCollection> emCands(new L1CaloEmCollection);
+  emCands->reserve(record.nEmCands);
+  for (unsigned int c = 0; c < record.nEmCands; ++c)
+    emCands->push_back(uctcore::makeL1CaloEmCand(record.emCands[c]));
+
+  evt.put(regions);
+  evt.put(emCands);
+}
+
+DEFINE_FWK_MODULE(UCTRecordedDigis);
@@ -46,7 +46,15 @@ CorrectedDigis = cms.EDProducer(
     regionLSB = RCTConfigProducers.jetMETLSB,
     egammaLSB = cms.double(1.0), # This has to correspond with the value from L1CaloEmThresholds
     regionSF = regionSF_8TeV_data,
-    regionSubtraction = regionSubtraction_8TeV_data
+    regionSubtraction = regionSubtraction_8TeV_data,
+    # If set, regionSF and regionSubtraction are instead read from these
+    # tables of a calibration file (made with test/UCTMakeCalibrationFile),
+    # which is reread between luminosity blocks when it changes.  Its
+    # checksum is then put in each luminosity block (CalibrationChecksum).
+    calibrationFile = cms.string(''),
+    regionSFTable = cms.string('regionSF_8TeV_data'),
+    regionSubtractionTable = cms.string('regionSubtraction_8TeV_data'),
+    uctDigisTag = cms.InputTag("uctDigis"),
 )
 
 UCT2015Producer = cms.EDProducer(
@@ -56,6 +64,9 @@ UCT2015Producer = cms.EDProducer(
     puMultCorrect = cms.bool(True), # PU subtract regions (superseedes CorrectedDigis if set to false)
     useUICrho = cms.bool(False), 
     useHI = cms.bool(False),
+    # Integer arithmetic for the PU levels, the energy sums and the jetSF
+    # calibration only; jet finding and EG/tau isolation stay floating point.
+    useFixedPointSumsAndJetSF = cms.bool(False),
     # All of these uint32 thresholds are in GeV.
     puETMax = cms.uint32(7),
     regionETCutForHT = cms.uint32(7),
@@ -72,6 +83,24 @@ UCT2015Producer = cms.EDProducer(
     egammaLSB = cms.double(1.0), # This has to correspond with the value from L1CaloEmThresholds
     regionLSB = RCTConfigProducers.jetMETLSB,
     jetSF = jetSF_8TeV_data,
+    # If set, jetSF is instead read from this table of a calibration file, as
+    # for CorrectedDigis.
+    calibrationFile = cms.string(''),
+    jetSFTable = cms.string('jetSF_8TeV_data'),
+    # The EM candidates, and the regions unless puMultCorrect is set without
+    # the region correction fused (see fuseRegionCorrection below).
+    uctDigisTag = cms.InputTag("uctDigis"),
+    # Set, with the region correction parameters, by fuseRegionCorrection.
+    fuseRegionCorrection = cms.bool(False),
+    # Also write a column-wise UCTCandidateTable next to each collection
+    produceCandidateTables = cms.bool(False),
+    # Build the candidate collections in per-event arena memory
+    useEventArena = cms.untracked.bool(False),
+    # Print how many times each processing stage ran at the end of the job
+    reportStageCounts = cms.untracked.bool(False),
+    # Output collections to produce (all if empty).  Stages only needed for
+    # collections which are not listed are skipped.
+    outputCollections = cms.vstring(),
 )
 
 uctDigiStep = cms.Sequence(
@@ -92,3 +121,28 @@ uctEmulatorStep = cms.Sequence(
 )
 
 emulationSequence = cms.Sequence(uctDigiStep * uctEmulatorStep)
+
+
+def fuseRegionCorrection(process, produceCorrectedRegions=False):
+    '''Do the region correction in UCT2015Producer, with the settings of
+    CorrectedDigis, and take CorrectedDigis out of uctEmulatorStep.  The
+    outputs are the same; the corrected regions are only put into the event
+    (as UCT2015Producer:CorrectedRegions) if produceCorrectedRegions is set.
+    '''
+    correction = process.CorrectedDigis
+    if not correction.puMultCorrect.value():
+        raise ValueError("fuseRegionCorrection needs CorrectedDigis.puMultCorrect")
+    producer = process.UCT2015Producer
+    # The PUM0 correction is then done as the first stage of UCT2015Producer,
+    # on the regions of uctDigisTag; the tables are those of CorrectedDigis,
+    # including the names in calibrationFile.
+    producer.fuseRegionCorrection = cms.bool(True)
+    producer.produceCorrectedRegions = cms.bool(produceCorrectedRegions)
+    producer.applyRegionCalibration = cms.bool(correction.applyCalibration.value())
+    producer.regionSF = cms.vdouble(correction.regionSF.value())
+    producer.regionSubtraction = cms.vdouble(correction.regionSubtraction.value())
+    producer.regionSFTable = cms.string(correction.regionSFTable.value())
+    producer.regionSubtractionTable = cms.string(correction.regionSubtractionTable.value())
+    producer.uctDigisTag = cms.InputTag(correction.uctDigisTag.value())
+    process.uctEmulatorStep.remove(correction)
+    return process
@@ -0,0 +1,31 @@
+#flake8: noqa
+'''
+
+Record the RCT regions and EM candidates of each event to a flat binary file
+(see interface/UCTEventFile.h), and put them back in the event in place of
+the RCT output:
+
+    process.uctEventFileWriter = uctEventFileWriter.clone(fileName = 'events.bin')
+    ...
+    process.uctDigis = uctRecordedDigis.clone(fileName = 'events.bin')
+
+Each event gets the record with its run, lumi and event number.  To replay
+the file without the original events, use an EmptySource and set
+replayInOrder; event n then gets record n - 1, so maxEvents must not be
+larger than the number of recorded events.
+
+'''
+
+import FWCore.ParameterSet.Config as cms
+
+uctEventFileWriter = cms.EDAnalyzer(
+    "UCTEventFileWriter",
+    src = cms.InputTag("uctDigis"),
+    fileName = cms.string("uct_events.bin"),
+)
+
+uctRecordedDigis = cms.EDProducer(
+    "UCTRecordedDigis",
+    fileName = cms.string("uct_events.bin"),
+    replayInOrder = cms.untracked.bool(False),
+)
@@ -0,0 +1,40 @@
+#flake8: noqa
+'''
+
+Synthetic RCT regions and EM candidates for a given pileup profile, to run
+the emulation without GEN-SIM and the RCT emulator.  To use them in place of
+the RCT output:
+
+    process.uctDigis = uctSyntheticDigis.clone(fixedPU = 140)
+
+The module and its generator are in the test plugins of the package
+(test/UCTSyntheticDigis.cc).
+
+'''
+
+import FWCore.ParameterSet.Config as cms
+
+from L1Trigger.UCT2015.regionSF_cfi import *
+
+uctSyntheticDigis = cms.EDProducer(
+    "UCTSyntheticDigis",
+    # Mean pileup ET per region and PUM0 bin, sets the per-eta occupancy and
+    # ET spectrum.
+    regionSubtraction = regionSubtraction_PU20_MC13TeV,
+    # Probability of 0, 1, 2... interactions; if empty, always fixedPU.
+    puProfile = cms.vdouble(),
+    fixedPU = cms.uint32(40),
+    puOccupancyScale = cms.double(50), # interactions for 63% of the regions
+    emCandFraction = cms.double(0.1),
+    tauVetoFraction = cms.double(0.1),
+    mipFraction = cms.double(0.05),
+    # Objects added to every event, flat in ET (GeV)
+    nJets = cms.uint32(0),
+    nTaus = cms.uint32(0),
+    nElectrons = cms.uint32(0),
+    minInjectedEt = cms.double(20),
+    maxInjectedEt = cms.double(100),
+    regionLSB = cms.double(0.5),
+    egammaLSB = cms.double(1.0),
+    seed = cms.uint32(1),
+)
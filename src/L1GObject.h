@@ -11,6 +11,8 @@ using std::string;
 #include "DataFormats/Candidate/interface/LeafCandidate.h"
 #include "DataFormats/Math/interface/LorentzVector.h"
 
+#include "L1Trigger/UCT2015/interface/helpers.h"
+
 /**
  * L1GObject represents a calorimeter global trigger object that
  * is made from global calorimeter quantities, total ET, missing ET.
@@ -111,20 +113,12 @@ public:
 
   double etaValue() const {
     if(myTwrGranularity) {
-      if(myEta < 28) {
-	return -twrEtaValues[-(myEta - 27)]; // 0-27 are negative eta values
-      }
-      else if(myEta < 56) {
-	return twrEtaValues[myEta - 28];     // 28-55 are positive eta values
-      }
+      if(myEta < (unsigned)uctgeo::N_TPG_ETA)
+	return uctgeo::tpgEta[myEta];
     }
     else {
-      if(myEta < 11) {
-	return -rgnEtaValues[-(myEta - 10)]; // 0-10 are negative eta values
-      }
-      else if (myEta < 22) {
-	return rgnEtaValues[myEta - 11];     // 11-21 are positive eta values
-      }
+      if(myEta < (unsigned)uctgeo::N_RGN_ETA)
+	return uctgeo::regionEta[myEta];
     }
     return 999.;
   }
@@ -245,28 +239,6 @@ public:
     for(unsigned int j = 37; j < 72; j++) {
       twrPhiValues[j] = -3.1415927 + 2. * 3.1415927 * (j - 36) / 72;
     }
-    rgnEtaValues[ 0] = 0.174; // HB and inner HE bins are 0.348 wide
-    rgnEtaValues[ 1] = 0.522;
-    rgnEtaValues[ 2] = 0.870;
-    rgnEtaValues[ 3] = 1.218;
-    rgnEtaValues[ 4] = 1.566;
-    rgnEtaValues[ 5] = 1.956; // Last two HE bins are 0.432 and 0.828 wide
-    rgnEtaValues[ 6] = 2.586;
-    rgnEtaValues[ 7] = 3.250; // HF bins are 0.5 wide
-    rgnEtaValues[ 8] = 3.750;
-    rgnEtaValues[ 9] = 4.250;
-    rgnEtaValues[10] = 4.750;
-    for(unsigned int i = 0; i < 20; i++) {
-      twrEtaValues[i] = 0.0435 + i * 0.087;
-    }
-    twrEtaValues[20] = 1.785;
-    twrEtaValues[21] = 1.880;
-    twrEtaValues[22] = 1.9865;
-    twrEtaValues[23] = 2.1075;
-    twrEtaValues[24] = 2.247;
-    twrEtaValues[25] = 2.411;
-    twrEtaValues[26] = 2.575;
-    twrEtaValues[27] = 2.825;
     myLSB = 1.0;
 
     // Initialize tuning parameters
@@ -319,9 +291,7 @@ private:
   bool myTwrGranularity;
 
   double myLSB;
-  double rgnEtaValues[11];
   double rgnPhiValues[18];
-  double twrEtaValues[28];
   double twrPhiValues[72];
 
 };
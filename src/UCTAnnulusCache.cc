@@ -0,0 +1,57 @@
+#include "L1Trigger/UCT2015/interface/UCTAnnulusCache.h"
+#include "L1Trigger/UCT2015/interface/UCTCoreTypes.h"
+#include <algorithm>
+
+namespace {
+  const UCTAnnulus emptyAnnulus = { 0., 0., 0, 0, false, false };
+}
+
+UCTAnnulusCache::UCTAnnulusCache() {
+  std::fill(annulus_, annulus_ + uctgrid::N_CELLS, emptyAnnulus);
+}
+
+void UCTAnnulusCache::build(const std::vector<uctcore::Region>& regions,
+    const UCTRegionGrid& grid) {
+  std::fill(annulus_, annulus_ + uctgrid::N_CELLS, emptyAnnulus);
+
+  // Each region contributes to the annulus of its neighbors.
+  for (unsigned int i = 0; i < regions.size(); ++i) {
+    const uctcore::Region& region = regions[i];
+    if (region.gctEta >= (unsigned)uctgrid::N_ETA ||
+        region.gctPhi >= (unsigned)uctgrid::N_PHI)
+      continue;
+    int cell = uctgrid::index(region.gctEta, region.gctPhi);
+    // Duplicates: the grid only holds one region per cell.
+    if (grid.region(cell) != &region)
+      continue;
+
+    double regionET = grid.et(cell);
+    bool egFlag = !region.mip && !region.tauVeto;
+    for (int dir = 0; dir < uctgrid::N_DIRECTIONS; ++dir) {
+      int n = uctgrid::neighborCell(cell, dir);
+      if (n < 0)
+        continue;
+      UCTAnnulus& annulus = annulus_[n];
+      if (regionET > annulus.highestEt) {
+        if (annulus.highestEt != 0)
+          annulus.secondEt = annulus.highestEt;
+        annulus.highestEt = regionET;
+        annulus.highestHasMip = region.mip;
+        annulus.highestHasEGFlag = egFlag;
+      }
+      if (region.mip)
+        ++annulus.mips;
+      if (egFlag)
+        ++annulus.egFlags;
+    }
+  }
+
+  // Don't count the flags of the highest neighbor.
+  for (int cell = 0; cell < uctgrid::N_CELLS; ++cell) {
+    UCTAnnulus& annulus = annulus_[cell];
+    if (annulus.highestHasMip)
+      --annulus.mips;
+    if (annulus.highestHasEGFlag)
+      --annulus.egFlags;
+  }
+}
@@ -0,0 +1,53 @@
+#include "L1Trigger/UCT2015/interface/UCTArena.h"
+#include <algorithm>
+
+UCTArena::UCTArena(size_t blockSize) :
+  enabled_(false), blockSize_(blockSize), current_(0), offset_(0), used_(0) {}
+
+UCTArena::~UCTArena() {
+  for (size_t i = 0; i < blocks_.size(); ++i)
+    ::operator delete(blocks_[i].data);
+}
+
+void* UCTArena::allocate(size_t bytes, size_t alignment) {
+  if (!enabled_)
+    return ::operator new(bytes);
+  while (true) {
+    if (current_ < blocks_.size()) {
+      const Block& block = blocks_[current_];
+      // Blocks come from operator new, so are aligned for any type.
+      size_t start = (offset_ + alignment - 1) / alignment * alignment;
+      if (start + bytes <= block.size) {
+        offset_ = start + bytes;
+        used_ += bytes;
+        return block.data + start;
+      }
+      // Doesn't fit, move on to the next block.
+      ++current_;
+      offset_ = 0;
+      continue;
+    }
+    Block block;
+    block.size = std::max(blockSize_, bytes);
+    block.data = static_cast<char*>(::operator new(block.size));
+    blocks_.push_back(block);
+  }
+}
+
+void UCTArena::deallocate(void* p) {
+  if (!enabled_)
+    ::operator delete(p);
+}
+
+void UCTArena::reset() {
+  current_ = 0;
+  offset_ = 0;
+  used_ = 0;
+}
+
+size_t UCTArena::bytesReserved() const {
+  size_t total = 0;
+  for (size_t i = 0; i < blocks_.size(); ++i)
+    total += blocks_[i].size;
+  return total;
+}
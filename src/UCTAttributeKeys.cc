@@ -0,0 +1,81 @@
+#include "L1Trigger/UCT2015/interface/UCTAttributeKeys.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// In the same order as uctkey::Key
+const char* const keyNames[] = {
+  "rgnEta",
+  "rgnPhi",
+  "rctEta",
+  "rctPhi",
+  "rank",
+  "gctEta",
+  "gctPhi",
+  "isIsolated",
+  "isEle",
+  "isHighPtEle",
+  "ellIsolation",
+  "tauVeto",
+  "mipBit",
+  "jetseed_et",
+  "neighborN_et",
+  "neighborS_et",
+  "neighborE_et",
+  "neighborW_et",
+  "neighborNE_et",
+  "neighborSW_et",
+  "neighborNW_et",
+  "neighborSE_et",
+  "associatedSecondRegionMIP",
+  "associatedJetPt",
+  "associatedRegionEt",
+  "associatedSecondRegionEt",
+  "associatedThirdRegionEt",
+  "puLevelHI",
+  "puLevelHIUIC",
+  "puLevelPUM0",
+  "uncorrectedPt"
+};
+
+static_assert(sizeof(keyNames) / sizeof(keyNames[0]) == uctkey::N_KEYS,
+    "keyNames must name every uctkey::Key");
+
+bool nameLess(uctkey::Key a, uctkey::Key b) {
+  return std::strcmp(keyNames[a], keyNames[b]) < 0;
+}
+
+bool nameLessThan(uctkey::Key a, const char* b) {
+  return std::strcmp(keyNames[a], b) < 0;
+}
+
+// Keys sorted by name, for binary search.
+struct SortedKeys {
+  SortedKeys() {
+    for (int i = 0; i < uctkey::N_KEYS; ++i)
+      keys[i] = uctkey::Key(i);
+    std::sort(keys, keys + uctkey::N_KEYS, nameLess);
+  }
+  uctkey::Key keys[uctkey::N_KEYS];
+};
+
+const SortedKeys& sortedKeys() {
+  static const SortedKeys sorted;
+  return sorted;
+}
+
+}
+
+const char* uctkey::name(Key key) {
+  return key < N_KEYS ? keyNames[key] : "";
+}
+
+uctkey::Key uctkey::lookup(const std::string& name) {
+  const Key* begin = sortedKeys().keys;
+  const Key* end = begin + N_KEYS;
+  const Key* found = std::lower_bound(begin, end, name.c_str(), nameLessThan);
+  if (found != end && name == keyNames[*found])
+    return *found;
+  return N_KEYS;
+}
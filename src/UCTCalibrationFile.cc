@@ -0,0 +1,215 @@
+#include "L1Trigger/UCT2015/interface/UCTCalibrationFile.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace uctcalib {
+
+namespace {
+
+const char MAGIC[8] = { 'U', 'C', 'T', 'C', 'A', 'L', 'I', 'B' };
+
+std::string systemError(const std::string& what, const std::string& fileName) {
+  return what + " " + fileName + ": " + std::strerror(errno);
+}
+
+// Reflected CRC-32 (as zlib), one byte at a time.
+struct CrcTable {
+  CrcTable() {
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint32_t c = i;
+      for (int k = 0; k < 8; ++k)
+        c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+      entry[i] = c;
+    }
+  }
+  uint32_t entry[256];
+};
+
+bool sameFile(const File& file, const struct stat& st) {
+  return file.device() == st.st_dev && file.inode() == st.st_ino &&
+    file.size() == st.st_size && file.mtime() == st.st_mtim.tv_sec &&
+    file.mtimeNsec() == st.st_mtim.tv_nsec;
+}
+
+} // namespace
+
+uint32_t crc32(const void* data, size_t size) {
+  static const CrcTable table;
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  uint32_t crc = 0xffffffffu;
+  for (size_t i = 0; i < size; ++i)
+    crc = table.entry[(crc ^ bytes[i]) & 0xff] ^ (crc >> 8);
+  return crc ^ 0xffffffffu;
+}
+
+bool write(const std::string& fileName, const TableList& tables, std::string* error) {
+  size_t size = sizeof(Header) + tables.size() * sizeof(TableEntry);
+  for (size_t t = 0; t < tables.size(); ++t) {
+    if (tables[t].first.size() >= MAX_NAME) {
+      *error = "table name " + tables[t].first + " is too long";
+      return false;
+    }
+    size += tables[t].second.size() * sizeof(double);
+  }
+
+  std::vector<char> buffer(size, 0);
+  Header* header = reinterpret_cast<Header*>(&buffer[0]);
+  TableEntry* entries = reinterpret_cast<TableEntry*>(&buffer[sizeof(Header)]);
+  size_t offset = sizeof(Header) + tables.size() * sizeof(TableEntry);
+  for (size_t t = 0; t < tables.size(); ++t) {
+    const std::vector<double>& values = tables[t].second;
+    std::strcpy(entries[t].name, tables[t].first.c_str());
+    entries[t].offset = offset;
+    entries[t].count = values.size();
+    if (!values.empty())
+      std::memcpy(&buffer[offset], &values[0], values.size() * sizeof(double));
+    offset += values.size() * sizeof(double);
+  }
+  std::memcpy(header->magic, MAGIC, sizeof(MAGIC));
+  header->version = VERSION;
+  header->nTables = tables.size();
+  header->size = size;
+  header->checksum = crc32(&buffer[sizeof(Header)], size - sizeof(Header));
+
+  std::string tmpName = fileName + ".tmp";
+  std::FILE* file = std::fopen(tmpName.c_str(), "wb");
+  if (!file) {
+    *error = systemError("cannot create", tmpName);
+    return false;
+  }
+  bool ok = std::fwrite(&buffer[0], size, 1, file) == 1;
+  ok = std::fclose(file) == 0 && ok;
+  if (!ok) {
+    *error = systemError("cannot write", tmpName);
+    std::remove(tmpName.c_str());
+    return false;
+  }
+  if (std::rename(tmpName.c_str(), fileName.c_str()) != 0) {
+    *error = systemError("cannot rename to", fileName);
+    std::remove(tmpName.c_str());
+    return false;
+  }
+  return true;
+}
+
+File::File() :
+  map_(0), mapSize_(0), header_(0), entries_(0),
+  device_(0), inode_(0), size_(0), mtime_(0), mtimeNsec_(0) {}
+
+File::~File() {
+  if (map_)
+    munmap(map_, mapSize_);
+}
+
+bool File::open(const std::string& fileName, std::string* error) {
+  int fd = ::open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    *error = systemError("cannot open", fileName);
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    *error = systemError("cannot stat", fileName);
+    ::close(fd);
+    return false;
+  }
+  size_t size = st.st_size;
+  if (size < sizeof(Header)) {
+    *error = fileName + " is not a UCT calibration file";
+    ::close(fd);
+    return false;
+  }
+  void* map = mmap(0, size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (map == MAP_FAILED) {
+    *error = systemError("cannot map", fileName);
+    return false;
+  }
+
+  const char* bytes = static_cast<const char*>(map);
+  const Header* header = reinterpret_cast<const Header*>(bytes);
+  const TableEntry* entries = reinterpret_cast<const TableEntry*>(bytes + sizeof(Header));
+  std::string problem;
+  if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0) {
+    problem = " is not a UCT calibration file";
+  } else if (header->version != VERSION) {
+    problem = " has an unsupported version";
+  } else if (header->size != size ||
+      header->nTables > (size - sizeof(Header)) / sizeof(TableEntry)) {
+    problem = " is truncated";
+  } else if (crc32(bytes + sizeof(Header), size - sizeof(Header)) != header->checksum) {
+    problem = " has a bad checksum";
+  } else {
+    for (uint32_t t = 0; t < header->nTables && problem.empty(); ++t) {
+      const TableEntry& entry = entries[t];
+      if (std::memchr(entry.name, 0, MAX_NAME) == 0 ||
+          entry.offset % sizeof(double) != 0 || entry.offset > size ||
+          entry.count > (size - entry.offset) / sizeof(double))
+        problem = " has a bad table directory";
+    }
+  }
+  if (!problem.empty()) {
+    *error = fileName + problem;
+    munmap(map, size);
+    return false;
+  }
+
+  if (map_)
+    munmap(map_, mapSize_);
+  fileName_ = fileName;
+  map_ = map;
+  mapSize_ = size;
+  header_ = header;
+  entries_ = entries;
+  device_ = st.st_dev;
+  inode_ = st.st_ino;
+  size_ = st.st_size;
+  mtime_ = st.st_mtim.tv_sec;
+  mtimeNsec_ = st.st_mtim.tv_nsec;
+  return true;
+}
+
+const double* File::table(const std::string& name, size_t* size) const {
+  if (!header_)
+    return 0;
+  for (uint32_t t = 0; t < header_->nTables; ++t) {
+    if (name == entries_[t].name) {
+      *size = entries_[t].count;
+      return reinterpret_cast<const double*>(
+          static_cast<const char*>(map_) + entries_[t].offset);
+    }
+  }
+  return 0;
+}
+
+bool File::get(const std::string& name, std::vector<double>* values) const {
+  size_t size;
+  const double* data = table(name, &size);
+  if (!data)
+    return false;
+  values->assign(data, data + size);
+  return true;
+}
+
+Watcher::Watcher(const std::string& fileName) : fileName_(fileName) {}
+
+std::shared_ptr<const File> Watcher::update(std::string* error) {
+  if (current_) {
+    struct stat st;
+    // A file which has gone away is not a change: keep what we have.
+    if (stat(fileName_.c_str(), &st) != 0 || sameFile(*current_, st))
+      return std::shared_ptr<const File>();
+  }
+  std::shared_ptr<File> file(new File);
+  if (!file->open(fileName_, error))
+    return std::shared_ptr<const File>();
+  return file;
+}
+
+} // namespace uctcalib
@@ -2,13 +2,19 @@
 #include "L1Trigger/UCT2015/interface/RegionAlgos.h"
 #include "FWCore/Utilities/interface/Exception.h"
 
-UCTCandidate::UCTCandidate() : reco::LeafCandidate() {}
+UCTCandidate::UCTCandidate() : reco::LeafCandidate(),
+  rgnEta_(0), rgnPhi_(0), rctEta_(0), rctPhi_(0), rank_(0),
+  isIsolated_(false), typedFieldsSet_(0),
+  nInts_(0), nFloats_(0), hasRegions_(false) {}
 
 UCTCandidate::UCTCandidate(double pt, double eta, double phi, double mass,
     const std::vector<UCTRegion>& regions) :
   reco::LeafCandidate(
       0, reco::LeafCandidate::PolarLorentzVector(pt, eta, phi, mass),
-      reco::LeafCandidate::Point(0, 0, 0), 0) {
+      reco::LeafCandidate::Point(0, 0, 0), 0),
+  rgnEta_(0), rgnPhi_(0), rctEta_(0), rctPhi_(0), rank_(0),
+  isIsolated_(false), typedFieldsSet_(0),
+  nInts_(0), nFloats_(0) {
     // copy over the region information.
     if (regions.size()) {
       hasRegions_ = true;
@@ -42,18 +48,30 @@ typename T::mapped_type getIfExists(const T& mapping,
 }
 
 float UCTCandidate::getFloat(const std::string& item) const {
+  uctkey::Key key = uctkey::lookup(item);
+  if (key != uctkey::N_KEYS)
+    return getFloat(key);
   return getIfExists(floatData_, item);
 }
 
 float UCTCandidate::getFloat(const std::string& item, float defaultVal) const {
+  uctkey::Key key = uctkey::lookup(item);
+  if (key != uctkey::N_KEYS)
+    return getFloat(key, defaultVal);
   return getIfExists(floatData_, item, defaultVal);
 }
 
 int UCTCandidate::getInt(const std::string& item) const {
+  uctkey::Key key = uctkey::lookup(item);
+  if (key != uctkey::N_KEYS)
+    return getInt(key);
   return getIfExists(intData_, item);
 }
 
 int UCTCandidate::getInt(const std::string& item, int defaultVal) const {
+  uctkey::Key key = uctkey::lookup(item);
+  if (key != uctkey::N_KEYS)
+    return getInt(key, defaultVal);
   return getIfExists(intData_, item, defaultVal);
 }
 
@@ -67,11 +85,19 @@ const std::string UCTCandidate::getString(const std::string& item,
 }
 
 void UCTCandidate::setFloat(const std::string& item, float value) {
-  floatData_[item] = value;
+  uctkey::Key key = uctkey::lookup(item);
+  if (key != uctkey::N_KEYS)
+    setFloat(key, value);
+  else
+    floatData_[item] = value;
 }
 
 void UCTCandidate::setInt(const std::string& item, int value) {
-  intData_[item] = value;
+  uctkey::Key key = uctkey::lookup(item);
+  if (key != uctkey::N_KEYS)
+    setInt(key, value);
+  else
+    intData_[item] = value;
 }
 
 void UCTCandidate::setString(const std::string& item,
@@ -79,6 +105,163 @@ void UCTCandidate::setString(const std::string& item,
   stringData_[item] = value;
 }
 
+bool UCTCandidate::isTypedField(uctkey::Key item) {
+  return item <= uctkey::rank || item == uctkey::isIsolated;
+}
+
+void UCTCandidate::setRegion(int rgnEta, int rgnPhi, int rctEta, int rctPhi) {
+  rgnEta_ = rgnEta;
+  rgnPhi_ = rgnPhi;
+  rctEta_ = rctEta;
+  rctPhi_ = rctPhi;
+  typedFieldsSet_ |= (1 << uctkey::rgnEta) | (1 << uctkey::rgnPhi) |
+    (1 << uctkey::rctEta) | (1 << uctkey::rctPhi);
+}
+
+void UCTCandidate::setRgnPhi(int rgnPhi) {
+  rgnPhi_ = rgnPhi;
+  typedFieldsSet_ |= 1 << uctkey::rgnPhi;
+}
+
+void UCTCandidate::setRank(int rank) {
+  rank_ = rank;
+  typedFieldsSet_ |= 1 << uctkey::rank;
+}
+
+void UCTCandidate::setIsolated(bool isolated) {
+  isIsolated_ = isolated;
+  typedFieldsSet_ |= 1 << uctkey::isIsolated;
+}
+
+const int* UCTCandidate::findInt(uctkey::Key item) const {
+  if (isTypedField(item)) {
+    if (!(typedFieldsSet_ & (1 << item)))
+      return NULL;
+    switch (item) {
+      case uctkey::rgnEta: return &rgnEta_;
+      case uctkey::rgnPhi: return &rgnPhi_;
+      case uctkey::rctEta: return &rctEta_;
+      case uctkey::rctPhi: return &rctPhi_;
+      case uctkey::rank: return &rank_;
+      default: break;
+    }
+    // isIsolated is stored as a bool
+    static const int isolatedValues[2] = {0, 1};
+    return &isolatedValues[isIsolated_];
+  }
+  for (unsigned int i = 0; i < nInts_; ++i) {
+    if (intKeys_[i] == item)
+      return &intValues_[i];
+  }
+  return NULL;
+}
+
+const float* UCTCandidate::findFloat(uctkey::Key item) const {
+  for (unsigned int i = 0; i < nFloats_; ++i) {
+    if (floatKeys_[i] == item)
+      return &floatValues_[i];
+  }
+  return NULL;
+}
+
+// Interned attributes which didn't fit in the inline arrays live in the maps
+// under their name.
+float UCTCandidate::getFloat(uctkey::Key item) const {
+  const float* value = findFloat(item);
+  if (value)
+    return *value;
+  return getIfExists(floatData_, uctkey::name(item));
+}
+
+float UCTCandidate::getFloat(uctkey::Key item, float defaultVal) const {
+  const float* value = findFloat(item);
+  if (value)
+    return *value;
+  if (floatData_.empty())
+    return defaultVal;
+  return getIfExists(floatData_, uctkey::name(item), defaultVal);
+}
+
+int UCTCandidate::getInt(uctkey::Key item) const {
+  const int* value = findInt(item);
+  if (value)
+    return *value;
+  return getIfExists(intData_, uctkey::name(item));
+}
+
+int UCTCandidate::getInt(uctkey::Key item, int defaultVal) const {
+  const int* value = findInt(item);
+  if (value)
+    return *value;
+  if (intData_.empty())
+    return defaultVal;
+  return getIfExists(intData_, uctkey::name(item), defaultVal);
+}
+
+void UCTCandidate::setFloat(uctkey::Key item, float value) {
+  float* existing = const_cast<float*>(findFloat(item));
+  if (existing)
+    *existing = value;
+  else if (nFloats_ < MAX_INLINE_FLOATS) {
+    floatKeys_[nFloats_] = item;
+    floatValues_[nFloats_] = value;
+    ++nFloats_;
+  } else
+    floatData_[uctkey::name(item)] = value;
+}
+
+void UCTCandidate::setInt(uctkey::Key item, int value) {
+  if (isTypedField(item)) {
+    switch (item) {
+      case uctkey::rgnEta: rgnEta_ = value; break;
+      case uctkey::rgnPhi: rgnPhi_ = value; break;
+      case uctkey::rctEta: rctEta_ = value; break;
+      case uctkey::rctPhi: rctPhi_ = value; break;
+      case uctkey::rank: rank_ = value; break;
+      default: isIsolated_ = value; break;
+    }
+    typedFieldsSet_ |= 1 << item;
+    return;
+  }
+  int* existing = const_cast<int*>(findInt(item));
+  if (existing)
+    *existing = value;
+  else if (nInts_ < MAX_INLINE_INTS) {
+    intKeys_[nInts_] = item;
+    intValues_[nInts_] = value;
+    ++nInts_;
+  } else
+    intData_[uctkey::name(item)] = value;
+}
+
+void UCTCandidate::internAttributes() {
+  // Inline attributes which are now typed fields
+  unsigned int nInts = 0;
+  for (unsigned int i = 0; i < nInts_; ++i) {
+    uctkey::Key key = uctkey::Key(intKeys_[i]);
+    if (isTypedField(key)) {
+      setInt(key, intValues_[i]);
+    } else {
+      intKeys_[nInts] = intKeys_[i];
+      intValues_[nInts] = intValues_[i];
+      ++nInts;
+    }
+  }
+  nInts_ = nInts;
+  std::map<std::string, int> intData;
+  intData.swap(intData_);
+  for (std::map<std::string, int>::const_iterator it = intData.begin();
+      it != intData.end(); ++it) {
+    setInt(it->first, it->second);
+  }
+  std::map<std::string, float> floatData;
+  floatData.swap(floatData_);
+  for (std::map<std::string, float>::const_iterator it = floatData.begin();
+      it != floatData.end(); ++it) {
+    setFloat(it->first, it->second);
+  }
+}
+
 bool UCTCandidate::operator < (const UCTCandidate& other) const {
   return this->pt() < other.pt();
 }
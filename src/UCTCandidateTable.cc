@@ -0,0 +1,45 @@
+#include "L1Trigger/UCT2015/interface/UCTCandidateTable.h"
+#include "L1Trigger/UCT2015/interface/UCTCandidate.h"
+
+UCTCandidateTable::UCTCandidateTable() {}
+
+UCTCandidateTable::UCTCandidateTable(const std::vector<UCTCandidate>& cands) {
+  reserve(cands.size());
+  for (size_t i = 0; i < cands.size(); ++i)
+    push_back(cands[i]);
+}
+
+void UCTCandidateTable::reserve(size_t n) {
+  pt_.reserve(n);
+  eta_.reserve(n);
+  phi_.reserve(n);
+  rank_.reserve(n);
+  rgnEta_.reserve(n);
+  rgnPhi_.reserve(n);
+  flags_.reserve(n);
+}
+
+void UCTCandidateTable::push_back(const UCTCandidate& cand) {
+  pt_.push_back(cand.pt());
+  eta_.push_back(cand.eta());
+  phi_.push_back(cand.phi());
+  rank_.push_back(cand.rank());
+  rgnEta_.push_back(cand.rgnEta());
+  rgnPhi_.push_back(cand.rgnPhi());
+
+  // Attributes which are not set count as false.
+  unsigned int flags = 0;
+  if (cand.isIsolated())
+    flags |= 1 << kIsolated;
+  if (cand.getInt(uctkey::isEle, 0))
+    flags |= 1 << kIsEle;
+  if (cand.getInt(uctkey::isHighPtEle, 0))
+    flags |= 1 << kIsHighPtEle;
+  if (cand.getInt(uctkey::ellIsolation, 0))
+    flags |= 1 << kEllIsolation;
+  if (cand.getInt(uctkey::tauVeto, 0))
+    flags |= 1 << kTauVeto;
+  if (cand.getInt(uctkey::mipBit, 0))
+    flags |= 1 << kMipBit;
+  flags_.push_back(flags);
+}
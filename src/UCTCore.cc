@@ -0,0 +1,564 @@
+#include "L1Trigger/UCT2015/interface/UCTCore.h"
+#include "L1Trigger/UCT2015/interface/UCTFixedPoint.h"
+#include "L1Trigger/UCT2015/interface/helpers.h"
+#include <cassert>
+#include <iostream>
+#include <math.h>
+
+namespace uctcore {
+
+namespace {
+
+// Half-width (in regions) of the square jet cone.
+const int JET_RADIUS = 1;
+
+double egPhysicalEt(const Config& config, const EmCand& cand) {
+  return config.egLSB*cand.rank;
+}
+
+double regionPhysicalEt(const Config& config, const Region& cand) {
+  return std::max(0.,config.regionLSB*cand.et);
+}
+
+// Region ET in GeV as a Q16 value, for the fixed-point mode.
+int64_t regionEtQ16(const Config& config, const Region& cand) {
+  return int64_t(cand.et) * config.regionLSBQ16;
+}
+
+// Whether the region ET is at least cut GeV, compared exactly in the
+// fixed-point mode.
+bool regionEtAbove(const Config& config, const Region& cand, unsigned int cut) {
+  if(config.useFixedPointSumsAndJetSF)
+    return regionEtQ16(config, cand) >= int64_t(cut) * uctfixed::ONE;
+  return regionPhysicalEt(config, cand) >= cut;
+}
+
+// ET in the jet cone centred on a region, as used for the jet pt.
+unsigned int jetConeEt(const EventState& state, int gctEta, int gctPhi) {
+  return state.jetEtSums.window(gctEta, gctPhi, JET_RADIUS);
+}
+
+// The region at a given position, or NULL if the event doesn't have one.
+const Region* regionAt(const EventState& state, int gctEta, int gctPhi) {
+  if(gctEta < 0 || gctEta >= uctgrid::N_ETA ||
+     gctPhi < 0 || gctPhi >= uctgrid::N_PHI) return 0;
+  return state.regionGrid.region(uctgrid::index(gctEta, gctPhi));
+}
+
+// The highest pt jet centred on a given region, or NULL if there is none.
+const Candidate* jetAt(const EventState& state, int gctEta, int gctPhi) {
+  if(gctEta < 0 || gctEta >= uctgrid::N_ETA ||
+     gctPhi < 0 || gctPhi >= uctgrid::N_PHI) return 0;
+  int i = state.jetIndex[uctgrid::index(gctEta, gctPhi)];
+  return i < 0 ? 0 : &state.jetList[i];
+}
+
+// Rebuild jetIndex from jetList.
+void indexJets(EventState& state) {
+  std::fill(state.jetIndex, state.jetIndex + uctgrid::N_CELLS, -1);
+  for(size_t i = 0; i < state.jetList.size(); ++i) {
+    const Candidate& jet = state.jetList[i];
+    if(jet.rgnEta() < 0 || jet.rgnEta() >= uctgrid::N_ETA ||
+       jet.rgnPhi() < 0 || jet.rgnPhi() >= uctgrid::N_PHI) continue;
+    int cell = uctgrid::index(jet.rgnEta(), jet.rgnPhi());
+    if(state.jetIndex[cell] < 0) state.jetIndex[cell] = i;
+  }
+}
+
+void puSubtraction(const Config& config, EventState& state) {
+  state.puLevelHI = 0;
+  state.puLevelHIUIC = 0;
+  double r_puLevelHIUIC=0.0;
+  double r_puLevelHIHI[uctgrid::N_ETA];
+
+  int etaCount[uctgrid::N_ETA];
+  for(int i = 0; i < uctgrid::N_ETA; ++i) {
+    state.puLevelHIHI[i] = 0;
+    r_puLevelHIHI[i] = 0.0;
+    etaCount[i] = 0;
+  }
+
+  int puCount = 0;
+  double Rarea=0.0;
+  int64_t areaQ16=0;
+  for(std::vector<Region>::const_iterator region = state.regions.begin();
+      region != state.regions.end(); ++region) {
+    if(regionPhysicalEt(config, *region) <= config.puETMax) {
+      state.puLevelHI += region->et; puCount++;
+      r_puLevelHIUIC += region->et;
+      Rarea += getRegionArea(region->gctEta);
+      areaQ16 += uctfixed::regionArea[region->gctEta];
+    }
+    r_puLevelHIHI[region->gctEta] += region->et;
+    etaCount[region->gctEta]++;
+  }
+  // Add a factor of 9, so it corresponds to a jet.  Reduces roundoff error.
+  state.puLevelHI *= 9;
+  if(puCount != 0) state.puLevelHI = state.puLevelHI / puCount;
+
+  if(config.useFixedPointSumsAndJetSF) {
+    // The ET sums are sums of integer ranks, so exact; only the divisions
+    // need rounding.
+    state.puLevelHIUIC = 0;
+    if(areaQ16 > 0)
+      state.puLevelHIUIC = uctfixed::divRound(int64_t(r_puLevelHIUIC) * uctfixed::ONE, areaQ16);
+    for(int i = 0; i < uctgrid::N_ETA; ++i)
+      state.puLevelHIHI[i] = etaCount[i] ? uctfixed::divRound(int64_t(r_puLevelHIHI[i]), etaCount[i]) : 0;
+    return;
+  }
+
+  r_puLevelHIUIC = r_puLevelHIUIC / Rarea;
+  state.puLevelHIUIC=0;
+  if (r_puLevelHIUIC > 0.) state.puLevelHIUIC = floor (r_puLevelHIUIC + 0.5);
+
+  for(int i = 0; i < uctgrid::N_ETA; ++i)
+    state.puLevelHIHI[i] = floor(r_puLevelHIHI[i]/etaCount[i] + 0.5);
+}
+
+void correctJets(const Config& config, const EventState& state,
+    const CandidateVector& jets, bool isJet, CandidateBuffer* corrected) {
+  corrected->reset();
+  // jet corrections only valid if PU density has been calculated
+  if (!config.applyJetCalibration) {
+    corrected->insert(corrected->end(), jets.begin(), jets.end());
+    return;
+  }
+
+  for(CandidateVector::const_iterator jet = jets.begin(); jet != jets.end(); jet++) {
+    const double jetET=jet->pt();
+    double alpha = config.jetSF[2*jet->rgnEta() + 0]; //Scale factor (See jetSF_cfi.py)
+    double gamma = ((config.jetSF[2*jet->rgnEta() + 1])); //Offset
+
+    unsigned int corjetET;
+    if(config.useFixedPointSumsAndJetSF) {
+      int64_t jptQ16 = int64_t(jetET) * config.jetSFQ16[2*jet->rgnEta() + 0]
+        + config.jetSFQ16[2*jet->rgnEta() + 1];
+      corjetET = (int) uctfixed::truncQ16(jptQ16);
+    } else {
+      double jpt = jetET*alpha+gamma;
+      corjetET =(int) jpt;
+    }
+
+    Candidate newJet(corjetET, convertRegionEta(jet->rgnEta()), convertRegionPhi(jet->rgnPhi()));
+    newJet.setFloat(uctkey::uncorrectedPt, jetET);
+    newJet.setRegion(jet->rgnEta(), jet->rgnPhi(),
+        jet->rctEta(), jet->rctPhi());
+    newJet.setRank(corjetET);
+
+    if(isJet) {
+      newJet.setInt(uctkey::jetseed_et, jet->getInt(uctkey::jetseed_et));
+      newJet.setInt(uctkey::neighborNW_et, jet->getInt(uctkey::neighborNW_et));
+      newJet.setInt(uctkey::neighborN_et, jet->getInt(uctkey::neighborN_et));
+      newJet.setInt(uctkey::neighborNE_et, jet->getInt(uctkey::neighborNE_et));
+      newJet.setInt(uctkey::neighborW_et, jet->getInt(uctkey::neighborW_et));
+      newJet.setInt(uctkey::neighborE_et, jet->getInt(uctkey::neighborE_et));
+      newJet.setInt(uctkey::neighborSW_et, jet->getInt(uctkey::neighborSW_et));
+      newJet.setInt(uctkey::neighborS_et, jet->getInt(uctkey::neighborS_et));
+      newJet.setInt(uctkey::neighborSE_et, jet->getInt(uctkey::neighborSE_et));
+    }
+    newJet.setFloat(uctkey::puLevelPUM0, state.puLevelPUM0);
+    newJet.setFloat(uctkey::puLevelHI, state.puLevelHI);
+    newJet.setFloat(uctkey::puLevelHIUIC, state.puLevelHIUIC);
+
+    corrected->push_back(newJet);
+  }
+
+  sortDescending(*corrected);
+}
+
+} // namespace
+
+Config::Config() :
+  puCorrectHI(false), applyJetCalibration(false), useHI(false),
+  useFixedPointSumsAndJetSF(false),
+  puETMax(0), regionETCutForHT(0), regionETCutForNeighbor(0),
+  regionETCutForMET(0), minGctEtaForSums(0), maxGctEtaForSums(0),
+  jetSeed(0), egtSeed(0), tauSeed(0),
+  relativeTauIsolationCut(0), relativeJetIsolationCut(0), switchOffTauIso(0),
+  egLSB(0), regionLSB(0), regionLSBQ16(0) {}
+
+void Config::deriveConstants() {
+  regionLSBQ16 = uctfixed::toQ16(regionLSB);
+  jetSFQ16.clear();
+  for(unsigned i = 0; i < jetSF.size(); ++i)
+    jetSFQ16.push_back(uctfixed::toQ16(jetSF[i]));
+}
+
+EventState::EventState(bool useEventArena) :
+  puLevelPUM0(-1),
+  puLevelHI(0),
+  puLevelHIUIC(0),
+  sumET(0), sumEx(0), sumEy(0), MET(0),
+  sumHT(0), sumHx(0), sumHy(0), MHT(0),
+  jetList(&eventArena),
+  corrJetList(&eventArena),
+  rlxTauList(&eventArena),
+  corrRlxTauList(&eventArena),
+  rlxEGList(&eventArena),
+  isoTauList(&eventArena),
+  corrIsoTauList(&eventArena),
+  isoEGList(&eventArena),
+  rlxTauRegionOnlyList(&eventArena),
+  isoTauRegionOnlyList(&eventArena)
+{
+  std::fill(puLevelHIHI, puLevelHIHI + uctgrid::N_ETA, 0);
+  std::fill(jetRegionEt, jetRegionEt + uctgrid::N_CELLS, 0.);
+  std::fill(jetIndex, jetIndex + uctgrid::N_CELLS, -1);
+  eventArena.setEnabled(useEventArena);
+}
+
+void sortDescending(CandidateVector& cands) {
+  std::stable_sort(cands.begin(), cands.end());
+  std::reverse(cands.begin(), cands.end());
+}
+
+void estimatePU(const Config& config, EventState& state) {
+  if(config.puCorrectHI) puSubtraction(config, state);
+}
+
+void buildGrid(const Config& config, EventState& state) {
+  state.regionGrid.fill(state.regions, config.regionLSB);
+  state.annulusCache.build(state.regions, state.regionGrid);
+}
+
+void makeSums(const Config& config, EventState& state) {
+  state.sumET = 0;
+  state.sumEx = 0;
+  state.sumEy = 0;
+  state.sumHT = 0;
+  state.sumHx = 0;
+  state.sumHy = 0;
+
+  // Fixed-point mode: Q16 sums of the ET, Q32 sums of the components.
+  int64_t sumETQ16 = 0, sumExQ32 = 0, sumEyQ32 = 0;
+  int64_t sumHTQ16 = 0, sumHxQ32 = 0, sumHyQ32 = 0;
+
+  for(std::vector<Region>::const_iterator region = state.regions.begin();
+      region != state.regions.end(); ++region) {
+    // Remove forward stuff
+    if (region->gctEta < config.minGctEtaForSums || region->gctEta > config.maxGctEtaForSums) {
+      continue;
+    }
+
+    double regionET = regionPhysicalEt(config, *region);
+
+    bool useForMET = regionEtAbove(config, *region, config.regionETCutForMET);
+    bool useForHT = regionEtAbove(config, *region, config.regionETCutForHT);
+    if(!useForHT && regionEtAbove(config, *region, config.regionETCutForNeighbor)) {
+      int cell = uctgrid::index(region->gctEta, region->gctPhi);
+      const int sides[4] = {uctgrid::N, uctgrid::S, uctgrid::E, uctgrid::W};
+      for(unsigned int i = 0; i < 4; ++i) {
+        const Region* neighbor = state.regionGrid.neighbor(cell, sides[i]);
+        if(neighbor && regionEtAbove(config, *neighbor, config.regionETCutForHT)) {
+          useForHT = true;
+        }
+      }
+    }
+
+    unsigned int iPhi = region->gctPhi;
+    if(config.useFixedPointSumsAndJetSF) {
+      int64_t regionETQ16 = regionEtQ16(config, *region);
+      if(useForMET) {
+        sumETQ16 += regionETQ16;
+        sumExQ32 += regionETQ16 * uctfixed::cosRegionPhi[iPhi];
+        sumEyQ32 += regionETQ16 * uctfixed::sinRegionPhi[iPhi];
+      }
+      if(useForHT) {
+        sumHTQ16 += regionETQ16;
+        sumHxQ32 += regionETQ16 * uctfixed::cosRegionPhi[iPhi];
+        sumHyQ32 += regionETQ16 * uctfixed::sinRegionPhi[iPhi];
+      }
+      continue;
+    }
+
+    if(useForMET) {
+      state.sumET += regionET;
+      state.sumEx += (int) (((double) regionET) * uctgeo::cosRegionPhi[iPhi]);
+      state.sumEy += (int) (((double) regionET) * uctgeo::sinRegionPhi[iPhi]);
+    }
+    if(useForHT) {
+      state.sumHT += regionET;
+      state.sumHx += (int) (((double) regionET) * uctgeo::cosRegionPhi[iPhi]);
+      state.sumHy += (int) (((double) regionET) * uctgeo::sinRegionPhi[iPhi]);
+    }
+  }
+
+  if(config.useFixedPointSumsAndJetSF) {
+    // Round toward zero once, on the totals.
+    state.sumET = uctfixed::truncQ16(sumETQ16);
+    state.sumEx = uctfixed::truncQ32(sumExQ32);
+    state.sumEy = uctfixed::truncQ32(sumEyQ32);
+    state.sumHT = uctfixed::truncQ16(sumHTQ16);
+    state.sumHx = uctfixed::truncQ32(sumHxQ32);
+    state.sumHy = uctfixed::truncQ32(sumHyQ32);
+    state.MET = uctfixed::isqrt(int64_t(state.sumEx) * state.sumEx + int64_t(state.sumEy) * state.sumEy);
+    state.MHT = uctfixed::isqrt(int64_t(state.sumHx) * state.sumHx + int64_t(state.sumHy) * state.sumHy);
+  } else {
+    state.MET = ((unsigned int) sqrt(state.sumEx * state.sumEx + state.sumEy * state.sumEy));
+    state.MHT = ((unsigned int) sqrt(state.sumHx * state.sumHx + state.sumHy * state.sumHy));
+  }
+
+  double physicalPhi = atan2(state.sumEy, state.sumEx) + 3.1415927;
+  unsigned int iPhi = uctgrid::N_PHI * physicalPhi / (2 * 3.1415927);
+  state.METObject = Candidate(state.MET, 0, physicalPhi);
+  state.METObject.setRgnPhi(iPhi);
+  state.METObject.setRank(state.MET);
+
+  double physicalPhiHT = atan2(state.sumHy, state.sumHx) + 3.1415927;
+  iPhi = uctgrid::N_PHI * (physicalPhiHT) / (2 * 3.1415927);
+  state.MHTObject = Candidate(state.MHT, 0, physicalPhiHT);
+  state.MHTObject.setRgnPhi(iPhi);
+  state.MHTObject.setRank(state.MHT);
+
+  state.SETObject = Candidate(state.sumET, 0, 0);
+  state.SETObject.setRank(state.sumET);
+
+  state.SHTObject = Candidate(state.sumHT, 0, 0);
+  state.SHTObject.setRank(state.sumHT);
+}
+
+void makeJets(const Config& config, EventState& state) {
+  state.jetList.reset();
+  bool subtractHI = config.puCorrectHI && config.useHI;
+  for(int cell = 0; cell < uctgrid::N_CELLS; ++cell) {
+    const Region* region = state.regionGrid.region(cell);
+    double regionET = state.regionGrid.et(cell);
+    if(region && subtractHI)
+      regionET = std::max(0.,regionET -
+                          (state.puLevelHIHI[region->gctEta]*config.regionLSB));
+    state.jetRegionEt[cell] = regionET;
+  }
+  state.jetEtSums.build(state.jetRegionEt);
+  // With HI subtraction every region is a seed candidate.
+  findJetSeeds(state.jetRegionEt, subtractHI ? -1. : config.jetSeed, &state.jetSeeds);
+
+  for(std::vector<Region>::const_iterator region = state.regions.begin();
+      region != state.regions.end(); ++region) {
+    int cell = uctgrid::index(region->gctEta, region->gctPhi);
+    if(!state.jetSeeds.isSeed(region->gctEta, region->gctPhi)) continue;
+
+    double regionET = state.jetRegionEt[cell];
+    // Neighbor ET in each uctgrid::Direction; missing neighbors stay 0.
+    double neighborEt[uctgrid::N_DIRECTIONS] = {0};
+    unsigned int nNeighbors = 0;
+    for(int dir = 0; dir < uctgrid::N_DIRECTIONS; ++dir) {
+      if(!state.regionGrid.neighbor(cell, dir)) continue;
+      neighborEt[dir] = state.jetRegionEt[uctgrid::neighborCell(cell, dir)];
+      nNeighbors++;
+    }
+    unsigned int jetET = state.jetSeeds.sum3x3[cell];
+
+    // Temporarily use the region granularity
+    int jetPhi = region->gctPhi;
+    int jetEta = region->gctEta;
+
+    bool neighborCheck = (nNeighbors == 8);
+    // On the eta edge we only expect 5 neighbors
+    if (!neighborCheck && (jetEta == 0 || jetEta == 21) && nNeighbors == 5)
+      neighborCheck = true;
+
+    if (!neighborCheck) {
+      std::cout << "phi: " << jetPhi << " eta: " << jetEta << " n: " << nNeighbors << std::endl;
+      std::cout << "JetPt: " << jetET << " regionET: " << regionET << std::endl;
+      assert(false);
+    }
+    Candidate theJet(jetET, convertRegionEta(jetEta), convertRegionPhi(jetPhi));
+    theJet.setRegion(jetEta, jetPhi, region->rctEta, region->rctPhi);
+    theJet.setRank(jetET);
+
+    theJet.setInt(uctkey::neighborNW_et, neighborEt[uctgrid::NW]);
+    theJet.setInt(uctkey::neighborW_et, neighborEt[uctgrid::W]);
+    theJet.setInt(uctkey::neighborSW_et, neighborEt[uctgrid::SW]);
+    theJet.setInt(uctkey::neighborNE_et, neighborEt[uctgrid::NE]);
+    theJet.setInt(uctkey::neighborE_et, neighborEt[uctgrid::E]);
+    theJet.setInt(uctkey::neighborSE_et, neighborEt[uctgrid::SE]);
+    theJet.setInt(uctkey::neighborN_et, neighborEt[uctgrid::N]);
+    theJet.setInt(uctkey::neighborS_et, neighborEt[uctgrid::S]);
+    theJet.setInt(uctkey::jetseed_et, regionET);
+
+    // Embed the puLevelHI information in the jet object for later tuning
+    theJet.setFloat(uctkey::puLevelPUM0, state.puLevelPUM0);
+    theJet.setFloat(uctkey::puLevelHI, state.puLevelHI);
+    theJet.setFloat(uctkey::puLevelHIUIC, state.puLevelHIUIC);
+    // Store information about the "core" PT of the jet (central region)
+    theJet.setFloat(uctkey::associatedRegionEt, regionET);
+    state.jetList.push_back(theJet);
+  }
+  sortDescending(state.jetList);
+  indexJets(state);
+}
+
+void calibrateJets(const Config& config, EventState& state) {
+  correctJets(config, state, state.jetList, true, &state.corrJetList);
+}
+
+void makeEGTaus(const Config& config, EventState& state) {
+  state.rlxTauList.reset();
+  state.isoTauList.reset();
+  state.rlxEGList.reset();
+  state.isoEGList.reset();
+  for(std::vector<EmCand>::const_iterator egtCand = state.emCands.begin();
+      egtCand != state.emCands.end(); ++egtCand) {
+    double et = egPhysicalEt(config, *egtCand);
+    if(et <= config.egtSeed) continue;
+
+    // The region the candidate sits in
+    const Region* region = regionAt(state, egtCand->gctEta, egtCand->gctPhi);
+    if(!region) continue;
+    double regionEt = regionPhysicalEt(config, *region);
+
+    // The old LUT is used, so every candidate is an electron.  The ID would
+    // be
+    //   et < 40: !tauVeto && !mip, 40 <= et < 63: !mip, et >= 63: any.
+    bool isEle = true;
+
+    // Find the highest region in the 3x3 annulus around the center region.
+    const UCTAnnulus& annulus = state.annulusCache.at(egtCand->gctEta, egtCand->gctPhi);
+    double associatedSecondRegionEt = annulus.highestEt;
+    unsigned int mipInSecondRegion = annulus.highestHasMip;
+
+    Candidate egtauCand(
+        et,
+        convertRegionEta(egtCand->gctEta),
+        convertRegionPhi(egtCand->gctPhi));
+
+    // Add extra information to the candidate
+    egtauCand.setRegion(egtCand->gctEta, egtCand->gctPhi,
+        egtCand->rctEta, egtCand->rctPhi);
+    egtauCand.setRank(egtCand->rank);
+    egtauCand.setFloat(uctkey::associatedJetPt, -3);
+    egtauCand.setFloat(uctkey::associatedRegionEt, regionEt);
+    egtauCand.setFloat(uctkey::associatedSecondRegionEt, associatedSecondRegionEt);
+    egtauCand.setInt(uctkey::associatedSecondRegionMIP, mipInSecondRegion);
+    egtauCand.setFloat(uctkey::puLevelHI, state.puLevelHI);
+    egtauCand.setFloat(uctkey::puLevelHIUIC, state.puLevelHIUIC);
+    egtauCand.setFloat(uctkey::puLevelPUM0, state.puLevelPUM0);
+    egtauCand.setInt(uctkey::ellIsolation, egtCand->isolated);
+    egtauCand.setInt(uctkey::tauVeto, region->tauVeto);
+    egtauCand.setInt(uctkey::mipBit, region->mip);
+    egtauCand.setInt(uctkey::isEle, isEle);
+
+    // A 2x1 and 1x2 cluster above egtSeed is always in tau list
+    state.rlxTauList.push_back(egtauCand);
+
+    // Note tauVeto now refers to emActivity pattern veto;
+    // Good patterns are from EG candidates
+    if (isEle) {
+      state.rlxEGList.push_back(egtauCand);
+    }
+
+    // Look for overlapping jet and require that isolation be passed
+    const Candidate* jet = jetAt(state, egtCand->gctEta, egtCand->gctPhi);
+    if(jet) {
+      // Embed tuning parameters into the relaxed objects
+      state.rlxTauList.back().setFloat(uctkey::associatedJetPt, jet->pt());
+
+      // EG ID enabled! MC
+      if (isEle) {
+        state.rlxEGList.back().setFloat(uctkey::associatedJetPt, jet->pt());
+        bool isHighPtEle=true;
+        if(jet->pt()>2*regionEt) isHighPtEle=false;
+        state.rlxEGList.back().setInt(uctkey::isHighPtEle,isHighPtEle);
+      }
+
+      unsigned int jetPt = jetConeEt(state, egtCand->gctEta, egtCand->gctPhi);
+      double jetIsolation = jetPt - regionEt;        // Jet isolation
+      double relativeJetIsolation = jetIsolation / regionEt;
+      // A 2x1 and 1x2 cluster above egtSeed passing relative isolation will be in tau list
+      if(relativeJetIsolation < config.relativeTauIsolationCut || regionEt > config.switchOffTauIso) {
+        state.isoTauList.push_back(state.rlxTauList.back());
+      }
+      double jetIsolationEG = jetPt - et;        // Jet isolation
+      double relativeJetIsolationEG = jetIsolationEG / et;
+
+      bool isolatedEG=false;
+      if(et<63 && relativeJetIsolationEG < config.relativeJetIsolationCut) isolatedEG=true;
+      if (et>=63) isolatedEG=true;
+
+      if(isEle) {
+        state.rlxEGList.back().setIsolated(isolatedEG);
+        if(isolatedEG) {
+          state.isoEGList.push_back(state.rlxEGList.back());
+        }
+      }
+    } else if(isEle) {
+      state.rlxEGList.back().setFloat(uctkey::associatedJetPt,-777);
+      state.rlxEGList.back().setInt(uctkey::isHighPtEle,true);
+      state.rlxEGList.back().setIsolated(true);
+      state.isoEGList.push_back(state.rlxEGList.back());
+    }
+  }
+  sortDescending(state.rlxEGList);
+  sortDescending(state.rlxTauList);
+  sortDescending(state.isoEGList);
+  sortDescending(state.isoTauList);
+}
+
+void makeTaus(const Config& config, EventState& state) {
+  state.rlxTauRegionOnlyList.reset();
+  state.isoTauRegionOnlyList.reset();
+  for(std::vector<Region>::const_iterator region = state.regions.begin();
+      region != state.regions.end(); ++region) {
+    double regionEt = regionPhysicalEt(config, *region);
+    if(regionEt<config.tauSeed) continue;
+
+    const UCTAnnulus& annulus = state.annulusCache.at(region->gctEta, region->gctPhi);
+    double associatedSecondRegionEt = annulus.highestEt;
+    double associatedThirdRegionEt = annulus.secondEt;
+    unsigned int mipInSecondRegion = annulus.highestHasMip;
+
+    double tauEt=regionEt;
+
+    Candidate tauCand(
+        tauEt,
+        convertRegionEta(region->gctEta),    // this is wrong (should take into acount the neighbours and center the tau in the division
+        convertRegionPhi(region->gctPhi));   // also, two taus will appear! we need to remove one
+
+    tauCand.setInt(uctkey::gctEta, region->gctEta);
+    tauCand.setInt(uctkey::gctPhi, region->gctPhi);
+    tauCand.setRegion(region->gctEta, region->gctPhi,
+        region->rctEta, region->rctPhi);
+    tauCand.setFloat(uctkey::associatedJetPt, -3);
+    tauCand.setFloat(uctkey::associatedRegionEt, regionEt);
+    tauCand.setFloat(uctkey::puLevelHI, state.puLevelHI);
+    tauCand.setFloat(uctkey::puLevelHIUIC, state.puLevelHIUIC);
+    tauCand.setFloat(uctkey::puLevelPUM0, state.puLevelPUM0);
+    tauCand.setInt(uctkey::tauVeto, region->tauVeto);
+    tauCand.setInt(uctkey::mipBit, region->mip);
+    tauCand.setFloat(uctkey::associatedSecondRegionEt, associatedSecondRegionEt);
+    tauCand.setInt(uctkey::associatedSecondRegionMIP, mipInSecondRegion);
+    tauCand.setFloat(uctkey::associatedThirdRegionEt, associatedThirdRegionEt);
+
+    state.rlxTauRegionOnlyList.push_back(tauCand);
+
+    // Look for overlapping jet and require that isolation be passed
+    const Candidate* jet = jetAt(state, region->gctEta, region->gctPhi);
+    if(jet) {
+      state.rlxTauRegionOnlyList.back().setFloat(uctkey::associatedJetPt, jet->pt());
+
+      double jetIsolation = jetConeEt(state, region->gctEta, region->gctPhi) - regionEt;        // Jet isolation
+      double relativeJetIsolation = jetIsolation / regionEt;
+      if(relativeJetIsolation < config.relativeTauIsolationCut || regionEt > config.switchOffTauIso) {
+        state.isoTauRegionOnlyList.push_back(state.rlxTauRegionOnlyList.back());
+      }
+    } else {
+      state.rlxTauRegionOnlyList.back().setFloat(uctkey::associatedJetPt, -777);
+      state.isoTauRegionOnlyList.push_back(state.rlxTauRegionOnlyList.back());
+    }
+  }
+  sortDescending(state.rlxTauRegionOnlyList);
+  sortDescending(state.isoTauRegionOnlyList);
+}
+
+void emulate(const Config& config, EventState& state) {
+  correctRegions(config, state);
+  estimatePU(config, state);
+  buildGrid(config, state);
+  makeSums(config, state);
+  makeJets(config, state);
+  calibrateJets(config, state);
+  makeEGTaus(config, state);
+  makeTaus(config, state);
+}
+
+} // namespace uctcore
@@ -0,0 +1,117 @@
+#include "L1Trigger/UCT2015/interface/UCTCoreAdapters.h"
+#include "L1Trigger/UCT2015/interface/UCTCandidate.h"
+#include "L1Trigger/UCT2015/interface/UCTEventFile.h"
+#include "DataFormats/L1CaloTrigger/interface/L1CaloRegion.h"
+#include "DataFormats/L1CaloTrigger/interface/L1CaloEmCand.h"
+
+namespace uctcore {
+
+Region makeRegion(const L1CaloRegion& region) {
+  Region out;
+  out.et = region.et();
+  out.gctEta = region.gctEta();
+  out.gctPhi = region.gctPhi();
+  out.rctEta = region.id().rctEta();
+  out.rctPhi = region.id().rctPhi();
+  out.overFlow = region.overFlow();
+  out.tauVeto = region.tauVeto();
+  out.mip = region.mip();
+  out.quiet = region.quiet();
+  out.fineGrain = region.fineGrain();
+  return out;
+}
+
+EmCand makeEmCand(const L1CaloEmCand& cand) {
+  EmCand out;
+  out.rank = cand.rank();
+  out.gctEta = cand.regionId().ieta();
+  out.gctPhi = cand.regionId().iphi();
+  out.rctEta = cand.regionId().rctEta();
+  out.rctPhi = cand.regionId().rctPhi();
+  out.isolated = cand.isolated();
+  return out;
+}
+
+void makeRegions(const std::vector<L1CaloRegion>& regions,
+    std::vector<Region>* out) {
+  out->clear();
+  out->reserve(regions.size());
+  for (unsigned int i = 0; i < regions.size(); ++i)
+    out->push_back(makeRegion(regions[i]));
+}
+
+void makeEmCands(const std::vector<L1CaloEmCand>& cands,
+    std::vector<EmCand>* out) {
+  out->clear();
+  out->reserve(cands.size());
+  for (unsigned int i = 0; i < cands.size(); ++i)
+    out->push_back(makeEmCand(cands[i]));
+}
+
+L1CaloRegion makeCorrectedL1CaloRegion(const L1CaloRegion& region, unsigned int et) {
+  unsigned int gctEta = region.gctEta();
+  if (gctEta < 18 && gctEta > 3) {
+    return L1CaloRegion(et, region.overFlow(), region.tauVeto(), region.mip(),
+        region.quiet(), region.rctCrate(), region.rctCard(),
+        region.rctRegionIndex());
+  }
+  // HF
+  return L1CaloRegion(et, region.fineGrain(), region.rctCrate(),
+      region.rctRegionIndex());
+}
+
+L1CaloRegion makeL1CaloRegion(const Region& region) {
+  // In HF the tau veto bit is the fine grain bit.
+  bool hf = region.gctEta < 4 || region.gctEta > 17;
+  return L1CaloRegion::makeRegionFromGctIndices(region.et, region.overFlow,
+      hf ? region.fineGrain : region.tauVeto, region.mip, region.quiet,
+      region.gctEta, region.gctPhi);
+}
+
+L1CaloEmCand makeL1CaloEmCand(const EmCand& cand) {
+  L1CaloRegionDetId id(cand.gctEta, cand.gctPhi);
+  return L1CaloEmCand(cand.rank, id.rctRegion(), id.rctCard(), id.rctCrate(),
+      cand.isolated);
+}
+
+uctfile::RegionWord makeRegionWord(const L1CaloRegion& region) {
+  uctfile::RegionWord word;
+  word.raw = region.raw();
+  word.gctEta = region.gctEta();
+  word.gctPhi = region.gctPhi();
+  return word;
+}
+
+uctfile::EmCandWord makeEmCandWord(const L1CaloEmCand& cand) {
+  uctfile::EmCandWord word;
+  word.raw = cand.raw();
+  word.gctEta = cand.regionId().ieta();
+  word.gctPhi = cand.regionId().iphi();
+  word.rctCrate = cand.rctCrate();
+  word.isolated = cand.isolated();
+  word.index = cand.index();
+  return word;
+}
+
+L1CaloRegion makeL1CaloRegion(const uctfile::RegionWord& word) {
+  return L1CaloRegion(word.raw, word.gctEta, word.gctPhi, 0);
+}
+
+L1CaloEmCand makeL1CaloEmCand(const uctfile::EmCandWord& word) {
+  return L1CaloEmCand(word.raw & 0x3f, (word.raw >> 6) & 0x1,
+      (word.raw >> 7) & 0x7, word.rctCrate, word.isolated, word.index, 0);
+}
+
+void appendUCTCandidate(const Candidate& cand, std::vector<UCTCandidate>* out) {
+  out->emplace_back(cand.pt(), cand.eta(), cand.phi());
+  UCTCandidate& added = out->back();
+  // setInt also fills the typed fields.
+  for (int key = 0; key < uctkey::N_KEYS; ++key) {
+    if (cand.hasInt(uctkey::Key(key)))
+      added.setInt(uctkey::Key(key), cand.getInt(uctkey::Key(key)));
+    if (cand.hasFloat(uctkey::Key(key)))
+      added.setFloat(uctkey::Key(key), cand.getFloat(uctkey::Key(key)));
+  }
+}
+
+} // namespace uctcore
@@ -0,0 +1,48 @@
+#include "L1Trigger/UCT2015/interface/UCTCore.h"
+#include <math.h>
+
+namespace uctcore {
+
+double gctSaturatedEgEt(double pt, bool saturate) {
+  // Something about the scale got messed up after 63!  Saturating...
+  if (saturate && pt >= 63)
+    return 63;
+  return pt;
+}
+
+unsigned int gctEmEta(unsigned int rgnEta, unsigned int rctEta) {
+  return (rctEta & 0x7) | (rgnEta < 11 ? 0x8 : 0x0);
+}
+
+unsigned int gctJetEta(unsigned int rgnEta, unsigned int rctEta) {
+  return ((rctEta % 7) & 0x7) | (rgnEta < 11 ? 0x8 : 0);
+}
+
+unsigned int gctJetPhi(unsigned int rgnPhi) {
+  return rgnPhi & 0x1f;
+}
+
+bool gctIsForwardJet(unsigned int rctEta) {
+  return rctEta >= 7;
+}
+
+unsigned int gctSumRank(double pt, double lsb) {
+  double convert = pt/lsb;
+  return (unsigned) convert;
+}
+
+unsigned int gctMETPhi(double phi) {
+  double phiMod = 36.*phi/M_PI;
+  if (phiMod < 0)
+    phiMod += 72;
+  return (unsigned) phiMod;
+}
+
+unsigned int gctMHTPhi(double phi) {
+  double phiMod = 9.*phi/M_PI;
+  if (phiMod < 0)
+    phiMod += 18.0;
+  return (unsigned) phiMod;
+}
+
+} // namespace uctcore
@@ -0,0 +1,120 @@
+#include "L1Trigger/UCT2015/interface/UCTCore.h"
+#include "L1Trigger/UCT2015/interface/UCTRegionCorrectionTable.h"
+#include "L1Trigger/UCT2015/interface/UCTRegionGrid.h"
+#include <algorithm>
+#include <ostream>
+
+namespace uctcore {
+
+void Ecal2x1Grid::clear() {
+  std::fill(rank_, rank_ + uctgrid::N_CELLS, 0u);
+  offGrid_.clear();
+}
+
+void Ecal2x1Grid::fill(const std::vector<EmCand>& emCands) {
+  clear();
+  for (std::vector<EmCand>::const_reverse_iterator egtCand = emCands.rbegin();
+      egtCand != emCands.rend(); ++egtCand)
+    set(egtCand->gctEta, egtCand->gctPhi, egtCand->rank);
+}
+
+void Ecal2x1Grid::set(unsigned int gctEta, unsigned int gctPhi, unsigned int rank) {
+  if (gctEta < (unsigned)uctgrid::N_ETA && gctPhi < (unsigned)uctgrid::N_PHI) {
+    rank_[uctgrid::index(gctEta, gctPhi)] = rank;
+  } else {
+    EmCand cand;
+    cand.gctEta = gctEta;
+    cand.gctPhi = gctPhi;
+    cand.rank = rank;
+    offGrid_.push_back(cand);
+  }
+}
+
+unsigned int Ecal2x1Grid::at(unsigned int gctEta, unsigned int gctPhi) const {
+  if (gctEta < (unsigned)uctgrid::N_ETA && gctPhi < (unsigned)uctgrid::N_PHI)
+    return rank_[uctgrid::index(gctEta, gctPhi)];
+  // The last one set is the first candidate.
+  for (std::vector<EmCand>::const_reverse_iterator egtCand = offGrid_.rbegin();
+      egtCand != offGrid_.rend(); ++egtCand) {
+    if (egtCand->gctEta == gctEta && egtCand->gctPhi == gctPhi)
+      return egtCand->rank;
+  }
+  return 0;
+}
+
+unsigned int correctedEt(const UCTRegionCorrectionTable& table, int pumBin,
+    unsigned int gctEta, unsigned int et, unsigned int energyECAL2x1,
+    std::ostream* debug) {
+  if (et == 0)
+    return 0;
+  // In region ET units (LSB=.5), see UCTRegionCorrectionTable.
+  int regionEtCorr = table.corrected(gctEta, pumBin, et, energyECAL2x1);
+  if (debug) {
+    const UCTRegionCorrectionTable::Entry& correction = table.at(gctEta, pumBin);
+    bool calibrated = et >= UCTRegionCorrectionTable::MIN_CALIBRATED_ET;
+    *debug << gctEta << "   " << et << "   " << energyECAL2x1
+      << "   " << correction.puSub << "     " << (calibrated ? correction.alpha : 1)
+      << "     " << (calibrated ? correction.gamma : 0)
+      << "-->" << regionEtCorr << "   " << std::endl;
+  }
+  return regionEtCorr;
+}
+
+unsigned int puMultiplicity(const std::vector<Region>& regions) {
+  unsigned int puMult = 0;
+  for (std::vector<Region>::const_iterator region = regions.begin();
+      region != regions.end(); ++region) {
+    if (region->et > 0)
+      ++puMult;
+  }
+  return puMult;
+}
+
+Region correctedRegion(const Region& region, unsigned int et) {
+  Region out = region;
+  if (region.gctEta < 18 && region.gctEta > 3) {
+    out.et = et & 0x3ff;
+    out.overFlow = region.overFlow || et > 0x3ff;
+  } else {
+    out.et = et & 0xff;
+    out.overFlow = et > 0xff;
+    out.mip = false;
+    out.quiet = false;
+  }
+  return out;
+}
+
+void correctRegions(const UCTRegionCorrectionTable& table,
+    const std::vector<Region>& regions, const std::vector<EmCand>& emCands,
+    int pumBin, std::vector<Region>* corrected, std::ostream* debug) {
+  Ecal2x1Grid ecal2x1;
+  ecal2x1.fill(emCands);
+  corrected->clear();
+  corrected->reserve(regions.size());
+  for (std::vector<Region>::const_iterator region = regions.begin();
+      region != regions.end(); ++region) {
+    Region out = *region;
+    out.et = correctedEt(table, pumBin, region->gctEta, region->et,
+        ecal2x1.at(region->gctEta, region->gctPhi), debug);
+    corrected->push_back(out);
+  }
+}
+
+void correctRegions(const Config& config, EventState& state) {
+  if (!config.regionCorrection)
+    return;
+  const UCTRegionCorrectionTable& table = *config.regionCorrection;
+  int pumBin = UCTRegionCorrectionTable::pumBin(puMultiplicity(state.regions));
+  Ecal2x1Grid ecal2x1;
+  ecal2x1.fill(state.emCands);
+  state.regionEtCorr.resize(state.regions.size());
+  for (size_t i = 0; i < state.regions.size(); ++i) {
+    const Region& region = state.regions[i];
+    state.regionEtCorr[i] = correctedEt(table, pumBin, region.gctEta, region.et,
+        ecal2x1.at(region.gctEta, region.gctPhi));
+    state.regions[i] = correctedRegion(state.regions[i], state.regionEtCorr[i]);
+  }
+  state.puLevelPUM0 = pumBin;
+}
+
+} // namespace uctcore
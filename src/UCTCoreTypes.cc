@@ -0,0 +1,18 @@
+#include "L1Trigger/UCT2015/interface/UCTCoreTypes.h"
+
+namespace uctcore {
+
+Candidate::Candidate() :
+  pt_(0), eta_(0), phi_(0), intsSet_(0), floatsSet_(0), ints_(), floats_() {}
+
+Candidate::Candidate(double pt, double eta, double phi) :
+  pt_(pt), eta_(eta), phi_(phi), intsSet_(0), floatsSet_(0), ints_(), floats_() {}
+
+void Candidate::setRegion(int rgnEta, int rgnPhi, int rctEta, int rctPhi) {
+  setInt(uctkey::rgnEta, rgnEta);
+  setInt(uctkey::rgnPhi, rgnPhi);
+  setInt(uctkey::rctEta, rctEta);
+  setInt(uctkey::rctPhi, rctPhi);
+}
+
+} // namespace uctcore
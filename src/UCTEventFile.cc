@@ -0,0 +1,250 @@
+#include "L1Trigger/UCT2015/interface/UCTEventFile.h"
+#include "L1Trigger/UCT2015/interface/UCTRegionGrid.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace uctfile {
+
+namespace {
+
+const char MAGIC[8] = { 'U', 'C', 'T', 'E', 'V', 'E', 'N', 'T' };
+
+std::string systemError(const std::string& what, const std::string& fileName) {
+  return what + " " + fileName + ": " + std::strerror(errno);
+}
+
+} // namespace
+
+uctcore::Region makeRegion(const RegionWord& word) {
+  uctcore::Region out;
+  bool hf = word.gctEta < 4 || word.gctEta > 17;
+  out.et = word.raw & (hf ? 0xff : 0x3ff);
+  out.gctEta = word.gctEta;
+  out.gctPhi = word.gctPhi;
+  out.rctEta = uctgrid::rctEta(word.gctEta);
+  out.rctPhi = uctgrid::rctPhi(word.gctPhi);
+  out.overFlow = (word.raw >> 10) & 1;
+  out.fineGrain = (word.raw >> 11) & 1;
+  out.tauVeto = !hf && out.fineGrain;
+  out.mip = (word.raw >> 12) & 1;
+  out.quiet = (word.raw >> 13) & 1;
+  return out;
+}
+
+uctcore::EmCand makeEmCand(const EmCandWord& word) {
+  uctcore::EmCand out;
+  out.rank = word.raw & 0x3f;
+  out.gctEta = word.gctEta;
+  out.gctPhi = word.gctPhi;
+  out.rctEta = uctgrid::rctEta(word.gctEta);
+  out.rctPhi = uctgrid::rctPhi(word.gctPhi);
+  out.isolated = word.isolated;
+  return out;
+}
+
+bool check(const Record& record, std::string* error) {
+  if (record.nRegions > MAX_REGIONS || record.nEmCands > MAX_EM_CANDS) {
+    *error = "too many regions or EM candidates";
+    return false;
+  }
+  for (unsigned int i = 0; i < record.nRegions; ++i) {
+    if (record.regions[i].gctEta >= uctgrid::N_ETA ||
+        record.regions[i].gctPhi >= uctgrid::N_PHI) {
+      *error = "a region is off the grid";
+      return false;
+    }
+  }
+  for (unsigned int i = 0; i < record.nEmCands; ++i) {
+    if (record.emCands[i].gctEta >= uctgrid::N_ETA ||
+        record.emCands[i].gctPhi >= uctgrid::N_PHI) {
+      *error = "an EM candidate is off the grid";
+      return false;
+    }
+  }
+  return true;
+}
+
+void unpack(const Record& record, std::vector<uctcore::Region>* regions,
+    std::vector<uctcore::EmCand>* emCands) {
+  regions->resize(record.nRegions);
+  for (unsigned int i = 0; i < record.nRegions; ++i)
+    (*regions)[i] = makeRegion(record.regions[i]);
+  emCands->resize(record.nEmCands);
+  for (unsigned int i = 0; i < record.nEmCands; ++i)
+    (*emCands)[i] = makeEmCand(record.emCands[i]);
+}
+
+Writer::Writer() : file_(0), nRecords_(0) {}
+
+Writer::~Writer() {
+  std::string error;
+  close(&error);
+}
+
+bool Writer::open(const std::string& fileName, std::string* error) {
+  if (file_ && !close(error))
+    return false;
+  file_ = std::fopen(fileName.c_str(), "wb");
+  if (!file_) {
+    *error = systemError("cannot create", fileName);
+    return false;
+  }
+  fileName_ = fileName;
+  nRecords_ = 0;
+
+  Header header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.recordSize = sizeof(Record);
+  header.maxRegions = MAX_REGIONS;
+  header.maxEmCands = MAX_EM_CANDS;
+  if (std::fwrite(&header, sizeof(header), 1, file_) != 1) {
+    *error = systemError("cannot write", fileName_);
+    return false;
+  }
+  return true;
+}
+
+bool Writer::write(const Record& record, std::string* error) {
+  std::string problem;
+  if (!check(record, &problem)) {
+    *error = "cannot write to " + fileName_ + ": " + problem;
+    return false;
+  }
+  // Zero the unused slots, so that the same input gives the same file.
+  Record out;
+  std::memcpy(&out, &record, sizeof(out));
+  std::memset(out.regions + out.nRegions, 0,
+      (MAX_REGIONS - out.nRegions) * sizeof(RegionWord));
+  std::memset(out.emCands + out.nEmCands, 0,
+      (MAX_EM_CANDS - out.nEmCands) * sizeof(EmCandWord));
+  out.unused = 0;
+  if (std::fwrite(&out, sizeof(out), 1, file_) != 1) {
+    *error = systemError("cannot write", fileName_);
+    return false;
+  }
+  ++nRecords_;
+  return true;
+}
+
+bool Writer::close(std::string* error) {
+  if (!file_)
+    return true;
+  bool ok = std::fclose(file_) == 0;
+  file_ = 0;
+  if (!ok)
+    *error = systemError("cannot close", fileName_);
+  return ok;
+}
+
+Reader::Reader() : map_(0), mapSize_(0), records_(0), nRecords_(0) {}
+
+Reader::~Reader() {
+  close();
+}
+
+bool Reader::open(const std::string& fileName, std::string* error) {
+  close();
+  int fd = ::open(fileName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    *error = systemError("cannot open", fileName);
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    *error = systemError("cannot stat", fileName);
+    ::close(fd);
+    return false;
+  }
+  size_t size = st.st_size;
+  if (size < sizeof(Header)) {
+    *error = fileName + " is not a UCT event file";
+    ::close(fd);
+    return false;
+  }
+  void* map = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (map == MAP_FAILED) {
+    *error = systemError("cannot map", fileName);
+    return false;
+  }
+
+  const Header& header = *static_cast<const Header*>(map);
+  std::string problem;
+  if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+    problem = " is not a UCT event file";
+  } else if (header.version != VERSION || header.recordSize != sizeof(Record) ||
+      header.maxRegions != MAX_REGIONS || header.maxEmCands != MAX_EM_CANDS) {
+    problem = " has an unsupported version or record layout";
+  } else if ((size - sizeof(Header)) % sizeof(Record) != 0) {
+    problem = " ends in the middle of a record";
+  }
+  if (!problem.empty()) {
+    *error = fileName + problem;
+    munmap(map, size);
+    return false;
+  }
+
+  // The records are read in order.
+  madvise(map, size, MADV_SEQUENTIAL);
+  map_ = map;
+  mapSize_ = size;
+  records_ = reinterpret_cast<const Record*>(static_cast<const char*>(map) + sizeof(Header));
+  nRecords_ = (size - sizeof(Header)) / sizeof(Record);
+
+  index_.resize(nRecords_);
+  for (size_t i = 0; i < nRecords_; ++i) {
+    const Record& record = records_[i];
+    if (!check(record, &problem)) {
+      std::ostringstream message;
+      message << "record " << i << " of " << fileName << " is corrupt: " << problem;
+      *error = message.str();
+      close();
+      return false;
+    }
+    EventIndex entry = { record.run, record.lumi, record.event, i };
+    index_[i] = entry;
+  }
+  std::sort(index_.begin(), index_.end());
+  return true;
+}
+
+bool Reader::EventIndex::operator<(const EventIndex& other) const {
+  if (run != other.run)
+    return run < other.run;
+  if (lumi != other.lumi)
+    return lumi < other.lumi;
+  if (event != other.event)
+    return event < other.event;
+  return record < other.record;
+}
+
+size_t Reader::find(uint32_t run, uint32_t lumi, uint64_t event) const {
+  EventIndex key = { run, lumi, event, 0 };
+  std::vector<EventIndex>::const_iterator found =
+    std::lower_bound(index_.begin(), index_.end(), key);
+  if (found == index_.end() || found->run != run || found->lumi != lumi ||
+      found->event != event)
+    return nRecords_;
+  return found->record;
+}
+
+void Reader::close() {
+  if (map_)
+    munmap(map_, mapSize_);
+  map_ = 0;
+  mapSize_ = 0;
+  records_ = 0;
+  nRecords_ = 0;
+  index_.clear();
+}
+
+} // namespace uctfile
@@ -0,0 +1,161 @@
+#include "L1Trigger/UCT2015/interface/UCTJetFinderKernel.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// The grid with one ring of padding: row 0 and row N_ETA+1 are the (empty)
+// regions beyond the eta edges, column 0 is gctPhi 17 and column N_PHI+1 is
+// gctPhi 0, so that the neighbors of every cell are plain offsets.  Extra
+// columns keep the last vector load inside the row.
+const int PAD_ROWS = uctgrid::N_ETA + 2;
+const int PAD_COLS = 24;
+
+struct PaddedGrid {
+  double et[PAD_ROWS][PAD_COLS];
+};
+
+void padGrid(const double* et, PaddedGrid* padded) {
+  std::memset(padded, 0, sizeof(PaddedGrid));
+  for (int e = 0; e < uctgrid::N_ETA; ++e) {
+    double* row = padded->et[e + 1];
+    std::copy(et + uctgrid::index(e, 0), et + uctgrid::index(e, uctgrid::N_PHI), row + 1);
+    row[0] = row[uctgrid::N_PHI];
+    row[uctgrid::N_PHI + 1] = row[1];
+  }
+}
+
+const unsigned int ROW_BITS = (1u << uctgrid::N_PHI) - 1;
+
+} // namespace
+
+void findJetSeedsScalar(const double* et, double seedThreshold, UCTJetSeeds* out) {
+  PaddedGrid padded;
+  padGrid(et, &padded);
+  for (int e = 0; e < uctgrid::N_ETA; ++e) {
+    const double* w = padded.et[e];       // gctEta - 1
+    const double* c = padded.et[e + 1];
+    const double* east = padded.et[e + 2]; // gctEta + 1
+    unsigned int mask = 0;
+    for (int p = 0; p < uctgrid::N_PHI; ++p) {
+      const int i = p + 1;
+      const double regionET = c[i];
+      if (regionET > seedThreshold &&
+          regionET > c[i - 1] &&      // N
+          regionET > w[i - 1] &&      // NW
+          regionET > w[i] &&          // W
+          regionET > w[i + 1] &&      // SW
+          regionET >= east[i - 1] &&  // NE
+          regionET >= east[i] &&      // E
+          regionET >= east[i + 1] &&  // SE
+          regionET >= c[i + 1]) {     // S
+        mask |= 1u << p;
+      }
+      out->sum3x3[uctgrid::index(e, p)] = regionET +
+        c[i - 1] + c[i + 1] + east[i] + w[i] +
+        east[i - 1] + w[i + 1] + east[i + 1] + w[i - 1];
+    }
+    out->rowMask[e] = mask;
+  }
+}
+
+#if defined(__AVX__) || defined(__SSE2__)
+
+void findJetSeeds(const double* et, double seedThreshold, UCTJetSeeds* out) {
+  PaddedGrid padded;
+  padGrid(et, &padded);
+#if defined(__AVX__)
+  const int WIDTH = 4;
+  const __m256d threshold = _mm256_set1_pd(seedThreshold);
+#else
+  const int WIDTH = 2;
+  const __m128d threshold = _mm_set1_pd(seedThreshold);
+#endif
+  double rowSums[PAD_COLS];
+  for (int e = 0; e < uctgrid::N_ETA; ++e) {
+    const double* w = padded.et[e];
+    const double* c = padded.et[e + 1];
+    const double* east = padded.et[e + 2];
+    unsigned int mask = 0;
+    for (int p = 0; p < uctgrid::N_PHI; p += WIDTH) {
+      const int i = p + 1;
+#if defined(__AVX__)
+      const __m256d regionET = _mm256_loadu_pd(c + i);
+      const __m256d n = _mm256_loadu_pd(c + i - 1);
+      const __m256d s = _mm256_loadu_pd(c + i + 1);
+      const __m256d ww = _mm256_loadu_pd(w + i);
+      const __m256d nw = _mm256_loadu_pd(w + i - 1);
+      const __m256d sw = _mm256_loadu_pd(w + i + 1);
+      const __m256d ee = _mm256_loadu_pd(east + i);
+      const __m256d ne = _mm256_loadu_pd(east + i - 1);
+      const __m256d se = _mm256_loadu_pd(east + i + 1);
+      __m256d pass = _mm256_cmp_pd(regionET, threshold, _CMP_GT_OQ);
+      pass = _mm256_and_pd(pass, _mm256_cmp_pd(regionET, n, _CMP_GT_OQ));
+      pass = _mm256_and_pd(pass, _mm256_cmp_pd(regionET, nw, _CMP_GT_OQ));
+      pass = _mm256_and_pd(pass, _mm256_cmp_pd(regionET, ww, _CMP_GT_OQ));
+      pass = _mm256_and_pd(pass, _mm256_cmp_pd(regionET, sw, _CMP_GT_OQ));
+      pass = _mm256_and_pd(pass, _mm256_cmp_pd(regionET, ne, _CMP_GE_OQ));
+      pass = _mm256_and_pd(pass, _mm256_cmp_pd(regionET, ee, _CMP_GE_OQ));
+      pass = _mm256_and_pd(pass, _mm256_cmp_pd(regionET, se, _CMP_GE_OQ));
+      pass = _mm256_and_pd(pass, _mm256_cmp_pd(regionET, s, _CMP_GE_OQ));
+      mask |= (unsigned int)_mm256_movemask_pd(pass) << p;
+      // same summation order as the scalar version
+      __m256d sum = _mm256_add_pd(regionET, n);
+      sum = _mm256_add_pd(sum, s);
+      sum = _mm256_add_pd(sum, ee);
+      sum = _mm256_add_pd(sum, ww);
+      sum = _mm256_add_pd(sum, ne);
+      sum = _mm256_add_pd(sum, sw);
+      sum = _mm256_add_pd(sum, se);
+      sum = _mm256_add_pd(sum, nw);
+      _mm256_storeu_pd(rowSums + p, sum);
+#else
+      const __m128d regionET = _mm_loadu_pd(c + i);
+      const __m128d n = _mm_loadu_pd(c + i - 1);
+      const __m128d s = _mm_loadu_pd(c + i + 1);
+      const __m128d ww = _mm_loadu_pd(w + i);
+      const __m128d nw = _mm_loadu_pd(w + i - 1);
+      const __m128d sw = _mm_loadu_pd(w + i + 1);
+      const __m128d ee = _mm_loadu_pd(east + i);
+      const __m128d ne = _mm_loadu_pd(east + i - 1);
+      const __m128d se = _mm_loadu_pd(east + i + 1);
+      __m128d pass = _mm_cmpgt_pd(regionET, threshold);
+      pass = _mm_and_pd(pass, _mm_cmpgt_pd(regionET, n));
+      pass = _mm_and_pd(pass, _mm_cmpgt_pd(regionET, nw));
+      pass = _mm_and_pd(pass, _mm_cmpgt_pd(regionET, ww));
+      pass = _mm_and_pd(pass, _mm_cmpgt_pd(regionET, sw));
+      pass = _mm_and_pd(pass, _mm_cmpge_pd(regionET, ne));
+      pass = _mm_and_pd(pass, _mm_cmpge_pd(regionET, ee));
+      pass = _mm_and_pd(pass, _mm_cmpge_pd(regionET, se));
+      pass = _mm_and_pd(pass, _mm_cmpge_pd(regionET, s));
+      mask |= (unsigned int)_mm_movemask_pd(pass) << p;
+      __m128d sum = _mm_add_pd(regionET, n);
+      sum = _mm_add_pd(sum, s);
+      sum = _mm_add_pd(sum, ee);
+      sum = _mm_add_pd(sum, ww);
+      sum = _mm_add_pd(sum, ne);
+      sum = _mm_add_pd(sum, sw);
+      sum = _mm_add_pd(sum, se);
+      sum = _mm_add_pd(sum, nw);
+      _mm_storeu_pd(rowSums + p, sum);
+#endif
+    }
+    // The last vector may run past gctPhi 17; drop those lanes.
+    out->rowMask[e] = mask & ROW_BITS;
+    std::copy(rowSums, rowSums + uctgrid::N_PHI, out->sum3x3 + uctgrid::index(e, 0));
+  }
+}
+
+#else
+
+void findJetSeeds(const double* et, double seedThreshold, UCTJetSeeds* out) {
+  findJetSeedsScalar(et, seedThreshold, out);
+}
+
+#endif
@@ -0,0 +1,112 @@
+#include "L1Trigger/UCT2015/interface/UCTRegionCorrectionTable.h"
+
+#include <cmath>
+#include <sstream>
+
+UCTRegionCorrectionTable::UCTRegionCorrectionTable() : lutEt_(0) {
+  for (int eta = 0; eta < N_ETA; ++eta) {
+    for (int bin = 0; bin < N_PUM_BINS; ++bin) {
+      Entry& entry = table_[eta][bin];
+      entry.puSub = 0;
+      entry.alpha = 1;
+      entry.gamma = 0;
+      entry.ecalStep = -1;
+    }
+  }
+}
+
+bool UCTRegionCorrectionTable::build(const std::vector<double>& regionSF,
+    const std::vector<double>& regionSubtraction,
+    bool applyCalibration, bool puMultCorrect, std::string* error) {
+  std::ostringstream problem;
+  if (applyCalibration && regionSF.size() < 2*N_ETA)
+    problem << "regionSF has " << regionSF.size() << " entries, " << 2*N_ETA
+      << " are needed";
+  else if (puMultCorrect && regionSubtraction.size() < 18*N_ETA)
+    problem << "regionSubtraction has " << regionSubtraction.size()
+      << " entries, " << 18*N_ETA << " are needed";
+  if (!problem.str().empty()) {
+    *error = problem.str();
+    return false;
+  }
+
+  for (int eta = 0; eta < N_ETA; ++eta) {
+    double alpha = 1;
+    double gamma = 0;
+    if (applyCalibration) {
+      alpha = regionSF[2*eta + 0];
+      // The offset needs to be divided by nine from the jet derived value,
+      // and multiplied by 2 to go from physical ET to region ET (LSB=.5).
+      gamma = 2*((regionSF[2*eta + 1])/3);
+    }
+    for (int bin = 0; bin < N_PUM_BINS; ++bin) {
+      Entry& entry = table_[eta][bin];
+      // Bins are laid out contiguously, so the last bin of one eta runs
+      // into the first of the next.
+      unsigned int i = 18*eta + bin;
+      // The subtraction is also given in physical ET.
+      entry.puSub = 0;
+      if (puMultCorrect && i < regionSubtraction.size())
+        entry.puSub = regionSubtraction[i]*2;
+      entry.alpha = alpha;
+      entry.gamma = gamma;
+    }
+  }
+  fillLut();
+  return true;
+}
+
+int UCTRegionCorrectionTable::compute(unsigned int gctEta, int pumBin,
+    unsigned int et, unsigned int ecal) const {
+  // Only non-empty regions are corrected
+  if (et == 0)
+    return 0;
+  double regionET = et;
+  double energyECAL2x1 = ecal;
+  const Entry& correction = table_[gctEta][pumBin];
+  double alpha = correction.alpha;
+  double gamma = correction.gamma;
+  if (regionET < MIN_CALIBRATED_ET) {
+    alpha = 1;
+    gamma = 0;
+  }
+  double puSub = correction.puSub;
+  if (regionET - puSub < 1)
+    return 0;
+  // Subtract the ECAL energy, calibrate what is left and add the ECAL
+  // energy back in.
+  double pum0pt = (int) (regionET - puSub - energyECAL2x1);
+  double corrpum0pt = pum0pt*alpha + gamma + energyECAL2x1;
+  if (corrpum0pt < 0)
+    corrpum0pt = 0;
+  return (int) (corrpum0pt);
+}
+
+void UCTRegionCorrectionTable::fillLut() {
+  lut_.resize(N_ETA * N_PUM_BINS * N_ET);
+  lutEt_ = N_ET;
+  for (int eta = 0; eta < N_ETA; ++eta) {
+    for (int bin = 0; bin < N_PUM_BINS; ++bin) {
+      uint16_t* row = &lut_[(eta*N_PUM_BINS + bin)*N_ET];
+      for (unsigned int et = 0; et < N_ET; ++et)
+        row[et] = compute(eta, bin, et, 0);
+
+      // Without calibration the ECAL energy cancels, except that
+      // (int)(ET - puSub - ECAL) rounds up instead of down once ECAL is
+      // above ET - puSub: the result goes up by one if ET - puSub is not a
+      // whole number.
+      Entry& entry = table_[eta][bin];
+      bool whole = false, fractional = false;
+      for (unsigned int et = 1; et < N_ET; ++et) {
+        double x = et - entry.puSub;
+        if (x < 1)
+          continue;
+        if (x == std::floor(x))
+          whole = true;
+        else
+          fractional = true;
+      }
+      entry.ecalStep = whole && fractional ? -1 : (fractional ? 1 : 0);
+    }
+  }
+}
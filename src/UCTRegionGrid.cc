@@ -0,0 +1,23 @@
+#include "L1Trigger/UCT2015/interface/UCTRegionGrid.h"
+#include "L1Trigger/UCT2015/interface/UCTCoreTypes.h"
+#include <algorithm>
+
+UCTRegionGrid::UCTRegionGrid() {
+  std::fill(region_, region_ + uctgrid::N_CELLS, (const uctcore::Region*)0);
+  std::fill(et_, et_ + uctgrid::N_CELLS, 0.);
+}
+
+void UCTRegionGrid::fill(const std::vector<uctcore::Region>& regions,
+    double regionLSB) {
+  std::fill(region_, region_ + uctgrid::N_CELLS, (const uctcore::Region*)0);
+  std::fill(et_, et_ + uctgrid::N_CELLS, 0.);
+  for (unsigned int i = 0; i < regions.size(); ++i) {
+    const uctcore::Region& region = regions[i];
+    if (region.gctEta >= (unsigned)uctgrid::N_ETA ||
+        region.gctPhi >= (unsigned)uctgrid::N_PHI)
+      continue;
+    int cell = uctgrid::index(region.gctEta, region.gctPhi);
+    region_[cell] = &region;
+    et_[cell] = std::max(0., regionLSB * region.et);
+  }
+}
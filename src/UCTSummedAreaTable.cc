@@ -0,0 +1,31 @@
+#include "L1Trigger/UCT2015/interface/UCTSummedAreaTable.h"
+#include <algorithm>
+
+UCTSummedAreaTable::UCTSummedAreaTable() {
+  for (int e = 0; e < N_ROWS; ++e)
+    std::fill(table_[e], table_[e] + N_COLS, 0.);
+}
+
+void UCTSummedAreaTable::build(const double* values) {
+  for (int e = 0; e < uctgrid::N_ETA; ++e) {
+    double rowSum = 0;
+    for (int p = 0; p < 2 * uctgrid::N_PHI; ++p) {
+      rowSum += values[uctgrid::index(e, p % uctgrid::N_PHI)];
+      table_[e + 1][p + 1] = table_[e][p + 1] + rowSum;
+    }
+  }
+}
+
+double UCTSummedAreaTable::sum(int etaLo, int etaHi, int phiLo, int nPhi) const {
+  etaLo = std::max(etaLo, 0);
+  etaHi = std::min(etaHi, uctgrid::N_ETA - 1);
+  nPhi = std::min(nPhi, uctgrid::N_PHI);
+  if (etaHi < etaLo || nPhi <= 0)
+    return 0;
+  phiLo %= uctgrid::N_PHI;
+  if (phiLo < 0)
+    phiLo += uctgrid::N_PHI;
+  const int phiHi = phiLo + nPhi;
+  return table_[etaHi + 1][phiHi] - table_[etaLo][phiHi]
+    - table_[etaHi + 1][phiLo] + table_[etaLo][phiLo];
+}
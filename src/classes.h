@@ -10,6 +10,7 @@
  */
 
 #include "L1Trigger/UCT2015/interface/UCTCandidate.h"
+#include "L1Trigger/UCT2015/interface/UCTCandidateTable.h"
 #include "L1Trigger/UCT2015/src/L1GObject.h"
 
 namespace {
@@ -22,6 +23,9 @@ namespace {
   std::vector<UCTCandidate> dummyUCTCandCollection;
   edm::Wrapper<std::vector<UCTCandidate> > dummyUCTCandCollectionWrapper;
 
+  UCTCandidateTable dummyUCTCandTable;
+  edm::Wrapper<UCTCandidateTable> dummyUCTCandTableWrapper;
+
   UCTRegion dummytRegion;
   std::vector<UCTRegion> dummyUCTRegionCollection;
   RegionDiscriminantInfo dummyDiscInfo;
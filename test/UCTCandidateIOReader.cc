@@ -0,0 +1,81 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  UCTCandidateIOReader.cc
+ *
+ *    Description:  Checks that the UCTCandidates written by
+ *                  UCTCandidateIOWriter, possibly with an older version of
+ *                  UCTCandidate, read back with all their attributes.
+ *
+ * =====================================================================================
+ */
+
+#include <vector>
+
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/one/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include "L1Trigger/UCT2015/test/UCTCandidateIOValues.h"
+
+class UCTCandidateIOReader : public edm::one::EDAnalyzer<> {
+  public:
+    explicit UCTCandidateIOReader(const edm::ParameterSet& pset);
+    virtual void analyze(const edm::Event& evt, const edm::EventSetup& es);
+  private:
+    edm::EDGetTokenT<std::vector<UCTCandidate> > token_;
+};
+
+UCTCandidateIOReader::UCTCandidateIOReader(const edm::ParameterSet& pset) :
+  token_(consumes<std::vector<UCTCandidate> >(pset.getParameter<edm::InputTag>("src"))) {
+}
+
+void UCTCandidateIOReader::analyze(const edm::Event& evt, const edm::EventSetup& es) {
+  edm::Handle<std::vector<UCTCandidate> > cands;
+  evt.getByToken(token_, cands);
+  if (cands->size() != uctiotest::N_CANDIDATES)
+    throw cms::Exception("UCTCandidateIO") << "Read " << cands->size()
+      << " candidates, expected " << uctiotest::N_CANDIDATES;
+
+  for (unsigned int i = 0; i < cands->size(); ++i) {
+    const UCTCandidate& cand = (*cands)[i];
+    UCTCandidate expected = uctiotest::makeCandidate(i);
+    if (cand.pt() != expected.pt() || cand.eta() != expected.eta() ||
+        cand.phi() != expected.phi())
+      throw cms::Exception("UCTCandidateIO") << "Candidate " << i
+        << " has the wrong kinematics: " << cand;
+    for (unsigned int attr = 0; attr < uctiotest::N_INTS; ++attr) {
+      const char* name = uctiotest::intNames[attr];
+      uctkey::Key key = uctkey::lookup(name);
+      int value = uctiotest::intValue(i, attr);
+      if (cand.getInt(name) != value ||
+          (key != uctkey::N_KEYS && cand.getInt(key) != value))
+        throw cms::Exception("UCTCandidateIO") << "Candidate " << i
+          << " has " << name << " = " << cand.getInt(name, -1)
+          << ", expected " << value;
+    }
+    for (unsigned int attr = 0; attr < uctiotest::N_FLOATS; ++attr) {
+      const char* name = uctiotest::floatNames[attr];
+      uctkey::Key key = uctkey::lookup(name);
+      float value = uctiotest::floatValue(i, attr);
+      if (cand.getFloat(name) != value ||
+          (key != uctkey::N_KEYS && cand.getFloat(key) != value))
+        throw cms::Exception("UCTCandidateIO") << "Candidate " << i
+          << " has " << name << " = " << cand.getFloat(name, -1)
+          << ", expected " << value;
+    }
+    if (cand.getString("testString") != uctiotest::stringValue(i))
+      throw cms::Exception("UCTCandidateIO") << "Candidate " << i
+        << " has testString = " << cand.getString("testString", "");
+    if (cand.rgnEta() != expected.rgnEta() || cand.rgnPhi() != expected.rgnPhi() ||
+        cand.rctEta() != expected.rctEta() || cand.rctPhi() != expected.rctPhi() ||
+        cand.rank() != expected.rank() || cand.isIsolated() != expected.isIsolated())
+      throw cms::Exception("UCTCandidateIO") << "Candidate " << i
+        << " has the wrong typed fields: " << cand;
+  }
+}
+
+DEFINE_FWK_MODULE(UCTCandidateIOReader);
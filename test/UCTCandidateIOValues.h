@@ -0,0 +1,64 @@
+#ifndef UCTCANDIDATEIOVALUES_K7QW2NBE
+#define UCTCANDIDATEIOVALUES_K7QW2NBE
+
+/*
+ * =====================================================================================
+ *
+ *       Filename:  UCTCandidateIOValues.h
+ *
+ *    Description:  The UCTCandidates written by UCTCandidateIOWriter and
+ *                  checked by UCTCandidateIOReader.  Only the string
+ *                  attribute interface is used, so that the writer also
+ *                  builds with older versions of UCTCandidate.
+ *
+ * =====================================================================================
+ */
+
+#include <string>
+#include <vector>
+#include "L1Trigger/UCT2015/interface/UCTCandidate.h"
+
+namespace uctiotest {
+
+// Integer and float attributes of the test candidates: typed fields,
+// interned attributes and ones which are not interned.
+const char* const intNames[] = {
+  "rgnEta", "rgnPhi", "rctEta", "rctPhi", "rank", "isIsolated",
+  "jetseed_et", "neighborN_et", "neighborS_et", "neighborE_et",
+  "neighborW_et", "mipBit", "tauVeto", "testInt"
+};
+const char* const floatNames[] = {
+  "puLevelHI", "puLevelPUM0", "associatedRegionEt", "uncorrectedPt",
+  "testFloat"
+};
+const unsigned int N_INTS = sizeof(intNames) / sizeof(intNames[0]);
+const unsigned int N_FLOATS = sizeof(floatNames) / sizeof(floatNames[0]);
+
+inline int intValue(unsigned int cand, unsigned int attr) {
+  return attr == 5 ? (cand + attr) % 2 : 7 * cand + attr;
+}
+
+inline float floatValue(unsigned int cand, unsigned int attr) {
+  return 0.5 * cand + 0.25 * attr;
+}
+
+inline std::string stringValue(unsigned int cand) {
+  return std::string("candidate ") + char('a' + cand % 26);
+}
+
+// The i-th candidate of an event.
+inline UCTCandidate makeCandidate(unsigned int i) {
+  UCTCandidate cand(10. + i, 0.1 * i, 0.2 * i);
+  for (unsigned int attr = 0; attr < N_INTS; ++attr)
+    cand.setInt(intNames[attr], intValue(i, attr));
+  for (unsigned int attr = 0; attr < N_FLOATS; ++attr)
+    cand.setFloat(floatNames[attr], floatValue(i, attr));
+  cand.setString("testString", stringValue(i));
+  return cand;
+}
+
+const unsigned int N_CANDIDATES = 12;
+
+}
+
+#endif /* end of include guard: UCTCANDIDATEIOVALUES_K7QW2NBE */
@@ -0,0 +1,40 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  UCTCandidateIOWriter.cc
+ *
+ *    Description:  Puts a fixed collection of UCTCandidates in every event,
+ *                  see UCTCandidateIOValues.h.  Used to write the reference
+ *                  files read back by UCTCandidateIOReader.
+ *
+ * =====================================================================================
+ */
+
+#include <memory>
+
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/EDProducer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+#include "L1Trigger/UCT2015/test/UCTCandidateIOValues.h"
+
+class UCTCandidateIOWriter : public edm::EDProducer {
+  public:
+    explicit UCTCandidateIOWriter(const edm::ParameterSet& pset);
+    virtual void produce(edm::Event& evt, const edm::EventSetup& es);
+};
+
+UCTCandidateIOWriter::UCTCandidateIOWriter(const edm::ParameterSet& pset) {
+  produces<std::vector<UCTCandidate> >();
+}
+
+void UCTCandidateIOWriter::produce(edm::Event& evt, const edm::EventSetup& es) {
+  std::auto_ptr<std::vector<UCTCandidate> > cands(new std::vector<UCTCandidate>);
+  for (unsigned int i = 0; i < uctiotest::N_CANDIDATES; ++i)
+    cands->push_back(uctiotest::makeCandidate(i));
+  evt.put(cands);
+}
+
+DEFINE_FWK_MODULE(UCTCandidateIOWriter);
@@ -0,0 +1,85 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  UCTCorrectedRegionTest.cc
+ *
+ *    Description:  Checks that uctcore::correctedRegion(), which the fused
+ *                  region correction of UCT2015Producer uses, packs a
+ *                  corrected ET the way makeCorrectedL1CaloRegion() (and so
+ *                  RegionCorrection) does: for every gctEta, ETs on both
+ *                  sides of the 8 and 10 bit limits and every combination
+ *                  of the region bits.  Exits with 1 on any difference.
+ *
+ * =====================================================================================
+ */
+
+#include <cstdio>
+
+#include "L1Trigger/UCT2015/interface/UCTCore.h"
+#include "L1Trigger/UCT2015/interface/UCTCoreAdapters.h"
+#include "DataFormats/L1CaloTrigger/interface/L1CaloRegion.h"
+
+namespace {
+
+const unsigned int ets[] = {0, 1, 0x7f, 0xff, 0x100, 0x101, 0x3ff, 0x400,
+  0x401, 0x7ff, 0x800, 0xfff};
+const unsigned int N_ETS = sizeof(ets) / sizeof(ets[0]);
+const unsigned int phis[] = {0, 1, 8, 17};
+const unsigned int N_PHIS = sizeof(phis) / sizeof(phis[0]);
+
+bool same(const uctcore::Region& a, const uctcore::Region& b) {
+  return a.et == b.et && a.gctEta == b.gctEta && a.gctPhi == b.gctPhi &&
+    a.rctEta == b.rctEta && a.rctPhi == b.rctPhi &&
+    a.overFlow == b.overFlow && a.tauVeto == b.tauVeto && a.mip == b.mip &&
+    a.quiet == b.quiet && a.fineGrain == b.fineGrain;
+}
+
+void print(const char* what, const uctcore::Region& region) {
+  printf("  %s: et %u eta %u phi %u rct %u,%u of %d tv %d mip %d q %d fg %d\n",
+      what, region.et, region.gctEta, region.gctPhi, region.rctEta,
+      region.rctPhi, region.overFlow, region.tauVeto, region.mip,
+      region.quiet, region.fineGrain);
+}
+
+}
+
+int main() {
+  unsigned int checked = 0;
+  unsigned int differences = 0;
+  for (unsigned int eta = 0; eta < uctgrid::N_ETA; ++eta) {
+    bool hf = eta < 4 || eta > 17;
+    for (unsigned int p = 0; p < N_PHIS; ++p) {
+      // The uncorrected region: an ET that fits, and each of the flags.
+      for (unsigned int flags = 0; flags < 16; ++flags) {
+        uctcore::Region in;
+        in.et = hf ? 0x42 : 0x142;
+        in.gctEta = eta;
+        in.gctPhi = phis[p];
+        in.overFlow = flags & 0x1;
+        in.tauVeto = flags & 0x2;
+        in.fineGrain = in.tauVeto;
+        in.mip = flags & 0x4;
+        in.quiet = flags & 0x8;
+        if (hf && (in.overFlow || in.mip || in.quiet))
+          continue;
+        L1CaloRegion l1 = uctcore::makeL1CaloRegion(in);
+        uctcore::Region region = uctcore::makeRegion(l1);
+        for (unsigned int e = 0; e < N_ETS; ++e) {
+          uctcore::Region core = uctcore::correctedRegion(region, ets[e]);
+          uctcore::Region framework = uctcore::makeRegion(
+              uctcore::makeCorrectedL1CaloRegion(l1, ets[e]));
+          ++checked;
+          if (!same(core, framework)) {
+            ++differences;
+            printf("corrected ET %u of region %u,%u (flags %x):\n", ets[e],
+                eta, phis[p], flags);
+            print("correctedRegion", core);
+            print("makeCorrectedL1CaloRegion", framework);
+          }
+        }
+      }
+    }
+  }
+  printf("%u of %u corrected regions differ\n", differences, checked);
+  return differences ? 1 : 0;
+}
@@ -0,0 +1,512 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  UCTDiffHarness.cc
+ *
+ *    Description:  Runs the reference algorithms (UCTReferenceEmulation.h)
+ *                  and the emulation core (UCTCore.h) on the same events and
+ *                  checks that every output agrees bit for bit: the
+ *                  corrected regions and PUM0 bin, the PU levels, and every
+ *                  UCT2015Producer collection candidate by candidate, with
+ *                  pt/eta/phi and each attribute (including whether it is
+ *                  set) compared exactly.  Stops at the first difference,
+ *                  printing both candidates and a map of the event.
+ *
+ *                  UCTDiffHarness [-n events] [-s seed] [-p pu] [-c dir]
+ *                                 [-m mode] [-a] [-f file]
+ *
+ *                  Events come from UCTEventGenerator, with a flat PU
+ *                  profile up to 200 or a fixed PU (-p), or from a file
+ *                  written by UCTEventFileWriter (-f), in which case -n
+ *                  limits the number of records and is otherwise all of
+ *                  them.  -c reads the
+ *                  regionSF, regionSubtraction and jetSF tables used by
+ *                  emulation_cfi.py from the cfi files in dir; otherwise
+ *                  made up tables are used.  Each event is run in three
+ *                  modes, or only in the one given with -m:
+ *                    0  PUM0 corrected and calibrated regions (as with
+ *                       CorrectedDigis); the core corrects them in its
+ *                       first stage, as UCT2015Producer does with
+ *                       fuseRegionCorrection
+ *                    1  uncorrected regions
+ *                    2  uncorrected regions with HI PU subtraction
+ *                  -a uses the per-event arena on the core side.
+ *
+ *                  The exit status is 0 if nothing differs, 1 otherwise.
+ *
+ * =====================================================================================
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <unistd.h>
+
+#include "L1Trigger/UCT2015/interface/UCTCore.h"
+#include "L1Trigger/UCT2015/interface/UCTEventFile.h"
+#include "L1Trigger/UCT2015/test/UCTEventGenerator.h"
+#include "L1Trigger/UCT2015/test/UCTReferenceEmulation.h"
+#include "L1Trigger/UCT2015/interface/UCTRegionCorrectionTable.h"
+
+namespace {
+
+const int N_MODES = 3;
+const char* modeNames[N_MODES] = {
+  "PUM0 corrected", "uncorrected", "HI subtracted"
+};
+
+struct Tables {
+  std::vector<double> regionSF;
+  std::vector<double> regionSubtraction;
+  std::vector<double> jetSF;
+};
+
+bool readTable(const std::string& fileName, const std::string& name,
+    std::vector<double>* values) {
+  std::ifstream in(fileName.c_str());
+  if (!UCTEventGenerator::readCfiVDouble(in, name, values)) {
+    std::fprintf(stderr, "no %s in %s\n", name.c_str(), fileName.c_str());
+    return false;
+  }
+  return true;
+}
+
+// The emulation_cfi.py settings, with the switches of the given mode.
+uctcore::Config makeConfig(const Tables& tables, int mode) {
+  uctcore::Config config;
+  config.puCorrectHI = mode == 2;
+  config.applyJetCalibration = true;
+  config.useHI = mode == 2;
+  config.puETMax = 7;
+  config.regionETCutForHT = 7;
+  config.regionETCutForNeighbor = 3;
+  config.regionETCutForMET = 0;
+  config.minGctEtaForSums = 4;
+  config.maxGctEtaForSums = 17;
+  config.jetSeed = 10;
+  config.tauSeed = 7;
+  config.egtSeed = 2;
+  config.relativeTauIsolationCut = 1.0;
+  config.relativeJetIsolationCut = 0.5;
+  config.switchOffTauIso = 100;
+  config.egLSB = 1.0;
+  config.regionLSB = 0.5;
+  config.jetSF = tables.jetSF;
+  config.deriveConstants();
+  return config;
+}
+
+bool sameBits(double a, double b) {
+  uint64_t x, y;
+  std::memcpy(&x, &a, sizeof(x));
+  std::memcpy(&y, &b, sizeof(y));
+  return x == y;
+}
+
+bool sameBits(float a, float b) {
+  uint32_t x, y;
+  std::memcpy(&x, &a, sizeof(x));
+  std::memcpy(&y, &b, sizeof(y));
+  return x == y;
+}
+
+// The first difference between two candidates, or "" if there is none.
+std::string compare(const uctcore::Candidate& ref, const uctcore::Candidate& opt) {
+  std::ostringstream diff;
+  diff.precision(17);
+  if (!sameBits(ref.pt(), opt.pt()))
+    diff << "pt: reference " << ref.pt() << ", core " << opt.pt();
+  else if (!sameBits(ref.eta(), opt.eta()))
+    diff << "eta: reference " << ref.eta() << ", core " << opt.eta();
+  else if (!sameBits(ref.phi(), opt.phi()))
+    diff << "phi: reference " << ref.phi() << ", core " << opt.phi();
+  if (!diff.str().empty())
+    return diff.str();
+  for (int i = 0; i < uctkey::N_KEYS; ++i) {
+    uctkey::Key key = uctkey::Key(i);
+    if (ref.hasInt(key) != opt.hasInt(key) || ref.getInt(key) != opt.getInt(key)) {
+      diff << uctkey::name(key) << ": reference ";
+      if (ref.hasInt(key)) diff << ref.getInt(key); else diff << "unset";
+      diff << ", core ";
+      if (opt.hasInt(key)) diff << opt.getInt(key); else diff << "unset";
+      return diff.str();
+    }
+    if (ref.hasFloat(key) != opt.hasFloat(key) || !sameBits(ref.getFloat(key), opt.getFloat(key))) {
+      diff << uctkey::name(key) << ": reference ";
+      if (ref.hasFloat(key)) diff << ref.getFloat(key); else diff << "unset";
+      diff << ", core ";
+      if (opt.hasFloat(key)) diff << opt.getFloat(key); else diff << "unset";
+      return diff.str();
+    }
+  }
+  return "";
+}
+
+void printCandidate(const char* which, const uctcore::Candidate& cand) {
+  std::printf("  %-9s pt=%.17g eta=%.17g phi=%.17g\n           ", which,
+      cand.pt(), cand.eta(), cand.phi());
+  for (int i = 0; i < uctkey::N_KEYS; ++i) {
+    uctkey::Key key = uctkey::Key(i);
+    if (cand.hasInt(key))
+      std::printf(" %s=%d", uctkey::name(key), cand.getInt(key));
+    if (cand.hasFloat(key))
+      std::printf(" %s=%.9g", uctkey::name(key), cand.getFloat(key));
+  }
+  std::printf("\n");
+}
+
+// Region ET by (phi, eta), with the flags and EM candidates of each region.
+void printRegionMap(const char* title, const std::vector<uctcore::Region>& regions,
+    const std::vector<uctcore::EmCand>& emCands) {
+  std::printf("%s (ET in region units; v tau veto or fine grain, m MIP, o overflow; then the EM candidates)\n", title);
+  std::vector<std::string> cells(uctgrid::N_CELLS, "      .");
+  for (size_t i = 0; i < regions.size(); ++i) {
+    const uctcore::Region& region = regions[i];
+    if (region.gctEta >= unsigned(uctgrid::N_ETA) || region.gctPhi >= unsigned(uctgrid::N_PHI))
+      continue;
+    char cell[16];
+    std::snprintf(cell, sizeof(cell), "%4u%c%c%c", region.et,
+        region.tauVeto || region.fineGrain ? 'v' : ' ', region.mip ? 'm' : ' ',
+        region.overFlow ? 'o' : ' ');
+    cells[uctgrid::index(region.gctEta, region.gctPhi)] = cell;
+  }
+  std::printf("phi\\eta");
+  for (int eta = 0; eta < uctgrid::N_ETA; ++eta)
+    std::printf("%7d", eta);
+  std::printf("\n");
+  for (int phi = 0; phi < uctgrid::N_PHI; ++phi) {
+    std::printf("%7d", phi);
+    for (int eta = 0; eta < uctgrid::N_ETA; ++eta)
+      std::printf("%s", cells[uctgrid::index(eta, phi)].c_str());
+    std::printf("\n");
+  }
+  for (size_t i = 0; i < emCands.size(); ++i) {
+    const uctcore::EmCand& cand = emCands[i];
+    std::printf("  e rank=%u gctEta=%u gctPhi=%u isolated=%d\n", cand.rank,
+        cand.gctEta, cand.gctPhi, cand.isolated);
+  }
+}
+
+class Harness {
+  public:
+    Harness(const Tables& tables, bool useEventArena);
+    ~Harness();
+    // False at the first difference, after reporting it.
+    // eventName identifies the event in the report.
+    bool run(const std::string& eventName, const UCTEventGenerator::Event& event, int mode);
+    unsigned long nCandidates() const { return nCandidates_; }
+
+  private:
+    bool compareCollection(const char* label, const uctref::CandidateList& ref,
+        const uctcore::CandidateVector& opt);
+    bool compareSingle(const char* label, const uctcore::Candidate& ref,
+        const uctcore::Candidate& opt);
+    void report(const std::string& what);
+
+    Tables tables_;
+    std::shared_ptr<UCTRegionCorrectionTable> correctionTable_;
+    // A configuration and event state per mode, as with one producer per
+    // mode: the state carries over from one event to the next.
+    uctcore::Config configs_[N_MODES];
+    uctcore::EventState* states_[N_MODES];
+    unsigned long nCandidates_;
+
+    // The event being compared, for the report.
+    std::string eventName_;
+    const UCTEventGenerator::Event* event_;
+    int mode_;
+    const std::vector<uctcore::Region>* input_;
+};
+
+Harness::Harness(const Tables& tables, bool useEventArena) :
+  tables_(tables), nCandidates_(0),
+  event_(0), mode_(0), input_(0) {
+  correctionTable_.reset(new UCTRegionCorrectionTable);
+  std::string error;
+  if (!correctionTable_->build(tables.regionSF, tables.regionSubtraction, true, true, &error)) {
+    std::fprintf(stderr, "%s\n", error.c_str());
+    std::exit(1);
+  }
+  for (int mode = 0; mode < N_MODES; ++mode) {
+    configs_[mode] = makeConfig(tables, mode);
+    states_[mode] = new uctcore::EventState(useEventArena);
+  }
+  configs_[0].regionCorrection = correctionTable_;
+}
+
+Harness::~Harness() {
+  for (int mode = 0; mode < N_MODES; ++mode)
+    delete states_[mode];
+}
+
+void Harness::report(const std::string& what) {
+  std::printf("DIFFERENCE in event %s, %s regions: %s\n",
+      eventName_.c_str(), modeNames[mode_], what.c_str());
+  printRegionMap("input regions", event_->regions, event_->emCands);
+  if (input_ != &event_->regions)
+    printRegionMap("regions given to the emulation", *input_, event_->emCands);
+}
+
+bool Harness::compareCollection(const char* label, const uctref::CandidateList& ref,
+    const uctcore::CandidateVector& opt) {
+  if (ref.size() != opt.size()) {
+    std::ostringstream what;
+    what << label << " has " << ref.size() << " candidates in the reference, "
+      << opt.size() << " in the core";
+    report(what.str());
+    uctref::CandidateList::const_iterator r = ref.begin();
+    for (size_t i = 0; i < std::max(ref.size(), opt.size()); ++i) {
+      std::printf(" [%zu]\n", i);
+      if (r != ref.end())
+        printCandidate("reference", *r++);
+      if (i < opt.size())
+        printCandidate("core", opt[i]);
+    }
+    return false;
+  }
+  uctref::CandidateList::const_iterator r = ref.begin();
+  for (size_t i = 0; i < opt.size(); ++i, ++r) {
+    std::string diff = compare(*r, opt[i]);
+    if (!diff.empty()) {
+      std::ostringstream what;
+      what << label << "[" << i << "] " << diff;
+      report(what.str());
+      printCandidate("reference", *r);
+      printCandidate("core", opt[i]);
+      return false;
+    }
+  }
+  nCandidates_ += opt.size();
+  return true;
+}
+
+bool Harness::compareSingle(const char* label, const uctcore::Candidate& ref,
+    const uctcore::Candidate& opt) {
+  std::string diff = compare(ref, opt);
+  if (!diff.empty()) {
+    report(std::string(label) + " " + diff);
+    printCandidate("reference", ref);
+    printCandidate("core", opt);
+    return false;
+  }
+  ++nCandidates_;
+  return true;
+}
+
+bool Harness::run(const std::string& eventName, const UCTEventGenerator::Event& event, int mode) {
+  eventName_ = eventName;
+  event_ = &event;
+  mode_ = mode;
+  input_ = &event.regions;
+  const uctcore::Config& config = configs_[mode];
+  uctcore::EventState& state = *states_[mode];
+
+  // RegionCorrection
+  std::vector<uctcore::Region> refCorrected, optCorrected;
+  unsigned int puLevelPUM0 = -1;
+  if (mode == 0) {
+    int refBin;
+    uctref::correctRegions(tables_.regionSF, tables_.regionSubtraction, true, true,
+        event.regions, event.emCands, &refCorrected, &refBin);
+    int optBin = UCTRegionCorrectionTable::pumBin(uctcore::puMultiplicity(event.regions));
+    uctcore::correctRegions(*correctionTable_, event.regions, event.emCands,
+        optBin, &optCorrected);
+    if (refBin != optBin) {
+      std::ostringstream what;
+      what << "PUM0 bin: reference " << refBin << ", core " << optBin;
+      report(what.str());
+      return false;
+    }
+    for (size_t i = 0; i < refCorrected.size(); ++i) {
+      if (refCorrected[i].et != optCorrected[i].et) {
+        std::ostringstream what;
+        what << "CorrectedRegions[" << i << "] (gctEta " << refCorrected[i].gctEta
+          << ", gctPhi " << refCorrected[i].gctPhi << ") ET: reference "
+          << refCorrected[i].et << ", core " << optCorrected[i].et;
+        report(what.str());
+        return false;
+      }
+    }
+    puLevelPUM0 = refBin;
+    // As UCT2015Producer reads them back from CorrectedRegions.
+    for (size_t i = 0; i < refCorrected.size(); ++i)
+      refCorrected[i] = uctcore::correctedRegion(event.regions[i], refCorrected[i].et);
+    input_ = &refCorrected;
+  }
+
+  // UCT2015Producer
+  uctref::Output ref;
+  uctref::emulate(config, *input_, event.emCands, puLevelPUM0, &ref);
+
+  // In mode 0 the core gets the uncorrected regions.
+  state.regions = event.regions;
+  if (!config.regionCorrection)
+    state.regions = *input_;
+  state.emCands = event.emCands;
+  state.puLevelPUM0 = config.regionCorrection ? -1 : puLevelPUM0;
+  uctcore::emulate(config, state);
+
+  bool same = true;
+  if (config.regionCorrection) {
+    if (state.puLevelPUM0 != puLevelPUM0) {
+      std::ostringstream what;
+      what << "PUM0 bin: reference " << puLevelPUM0 << ", core stage "
+        << state.puLevelPUM0;
+      report(what.str());
+      same = false;
+    }
+    for (size_t i = 0; same && i < refCorrected.size(); ++i) {
+      const uctcore::Region& ref = refCorrected[i];
+      const uctcore::Region& opt = state.regions[i];
+      if (ref.et != opt.et || ref.overFlow != opt.overFlow || ref.mip != opt.mip ||
+          ref.quiet != opt.quiet || state.regionEtCorr[i] != optCorrected[i].et) {
+        std::ostringstream what;
+        what << "CorrectedRegions[" << i << "] (gctEta " << ref.gctEta
+          << ", gctPhi " << ref.gctPhi << ") in the core stage: ET "
+          << ref.et << " (" << optCorrected[i].et << " before packing), core "
+          << opt.et << " (" << state.regionEtCorr[i] << ")";
+        report(what.str());
+        same = false;
+      }
+    }
+  }
+  if (config.puCorrectHI && (ref.puLevelHI != state.puLevelHI ||
+        ref.puLevelHIUIC != state.puLevelHIUIC)) {
+    std::ostringstream what;
+    what << "PU level: reference " << ref.puLevelHI << " (UIC " << ref.puLevelHIUIC
+      << "), core " << state.puLevelHI << " (UIC " << state.puLevelHIUIC << ")";
+    report(what.str());
+    same = false;
+  }
+  same = same &&
+    compareSingle("METUnpacked", ref.METObject, state.METObject) &&
+    compareSingle("MHTUnpacked", ref.MHTObject, state.MHTObject) &&
+    compareSingle("SETUnpacked", ref.SETObject, state.SETObject) &&
+    compareSingle("SHTUnpacked", ref.SHTObject, state.SHTObject) &&
+    compareCollection("JetUnpacked", ref.jetList, state.jetList) &&
+    compareCollection("CorrJetUnpacked", ref.corrJetList, state.corrJetList) &&
+    compareCollection("RelaxedTauEcalSeedUnpacked", ref.rlxTauList, state.rlxTauList) &&
+    compareCollection("IsolatedTauEcalSeedUnpacked", ref.isoTauList, state.isoTauList) &&
+    compareCollection("RelaxedEGUnpacked", ref.rlxEGList, state.rlxEGList) &&
+    compareCollection("IsolatedEGUnpacked", ref.isoEGList, state.isoEGList) &&
+    compareCollection("RelaxedTauUnpacked", ref.rlxTauRegionOnlyList, state.rlxTauRegionOnlyList) &&
+    compareCollection("IsolatedTauUnpacked", ref.isoTauRegionOnlyList, state.isoTauRegionOnlyList);
+
+  // End of event, as in UCT2015Producer::produce.
+  uctcore::CandidateBuffer* buffers[] = {
+    &state.jetList, &state.corrJetList, &state.rlxTauList,
+    &state.corrRlxTauList, &state.rlxEGList, &state.isoTauList,
+    &state.corrIsoTauList, &state.isoEGList,
+    &state.rlxTauRegionOnlyList, &state.isoTauRegionOnlyList
+  };
+  for (size_t b = 0; b < sizeof(buffers) / sizeof(buffers[0]); ++b)
+    buffers[b]->discard();
+  state.eventArena.reset();
+  return same;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  int nEvents = -1;
+  unsigned int seed = 1;
+  int fixedPU = -1;
+  int onlyMode = -1;
+  const char* cfiDir = 0;
+  bool useEventArena = false;
+  const char* eventFile = 0;
+  int opt;
+  while ((opt = getopt(argc, argv, "n:s:p:c:m:af:")) != -1) {
+    switch (opt) {
+      case 'n': nEvents = std::atoi(optarg); break;
+      case 's': seed = std::atoi(optarg); break;
+      case 'p': fixedPU = std::atoi(optarg); break;
+      case 'c': cfiDir = optarg; break;
+      case 'm': onlyMode = std::atoi(optarg); break;
+      case 'a': useEventArena = true; break;
+      case 'f': eventFile = optarg; break;
+      default:
+        std::fprintf(stderr, "usage: %s [-n events] [-s seed] [-p pu] [-c dir]"
+            " [-m mode] [-a] [-f file]\n", argv[0]);
+        return 2;
+    }
+  }
+  if (onlyMode >= N_MODES) {
+    std::fprintf(stderr, "no mode %d\n", onlyMode);
+    return 2;
+  }
+
+  Tables tables;
+  if (cfiDir) {
+    std::string dir(cfiDir);
+    if (!readTable(dir + "/regionSF_cfi.py", "regionSF_8TeV_data", &tables.regionSF) ||
+        !readTable(dir + "/regionSF_cfi.py", "regionSubtraction_8TeV_data", &tables.regionSubtraction) ||
+        !readTable(dir + "/jetSF_cfi.py", "jetSF_8TeV_data", &tables.jetSF))
+      return 2;
+  } else {
+    for (int eta = 0; eta < uctgrid::N_ETA; ++eta) {
+      tables.regionSF.push_back(1.2);
+      tables.regionSF.push_back(5.0);
+      tables.jetSF.push_back(1.1);
+      tables.jetSF.push_back(2.0);
+      for (int bin = 0; bin < 18; ++bin)
+        tables.regionSubtraction.push_back(0.5 * bin);
+    }
+  }
+
+  uctfile::Reader reader;
+  if (eventFile) {
+    std::string error;
+    if (!reader.open(eventFile, &error)) {
+      std::fprintf(stderr, "%s\n", error.c_str());
+      return 2;
+    }
+    if (nEvents < 0 || size_t(nEvents) > reader.size())
+      nEvents = reader.size();
+  } else if (nEvents < 0) {
+    nEvents = 1000;
+  }
+
+  UCTEventGenerator::Config generatorConfig;
+  generatorConfig.regionSubtraction = tables.regionSubtraction;
+  if (fixedPU >= 0)
+    generatorConfig.fixedPU = fixedPU;
+  else
+    generatorConfig.puProfile.assign(201, 1.);
+  generatorConfig.nJets = 2;
+  generatorConfig.nTaus = 1;
+  generatorConfig.nElectrons = 1;
+  generatorConfig.seed = seed;
+  UCTEventGenerator generator(generatorConfig);
+
+  Harness harness(tables, useEventArena);
+  UCTEventGenerator::Event event;
+  for (int i = 0; i < nEvents; ++i) {
+    char eventName[64];
+    if (eventFile) {
+      const uctfile::Record& record = reader.record(i);
+      uctfile::unpack(record, &event.regions, &event.emCands);
+      event.nPU = 0;
+      std::snprintf(eventName, sizeof(eventName), "%u:%u:%llu (record %d)",
+          record.run, record.lumi, (unsigned long long) record.event, i);
+    } else {
+      generator.generate(i, &event);
+      std::snprintf(eventName, sizeof(eventName), "%d (nPU %u)", i, event.nPU);
+    }
+    for (int mode = 0; mode < N_MODES; ++mode) {
+      if (onlyMode >= 0 && mode != onlyMode)
+        continue;
+      if (!harness.run(eventName, event, mode))
+        return 1;
+    }
+  }
+  std::printf("%d events, %lu candidates: no differences\n", nEvents,
+      harness.nCandidates());
+  return 0;
+}
@@ -0,0 +1,312 @@
+#include "L1Trigger/UCT2015/test/UCTEventGenerator.h"
+#include "L1Trigger/UCT2015/interface/UCTRegionGrid.h"
+#include "L1Trigger/UCT2015/interface/UCTRegionCorrectionTable.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <istream>
+#include <iterator>
+#include <random>
+
+namespace {
+
+const int N_PUM_BINS = 18;
+// Barrel and endcap, where EM candidates and tau vetos exist.
+const unsigned int MIN_CENTRAL_ETA = 4;
+const unsigned int MAX_CENTRAL_ETA = 17;
+const unsigned int MAX_REGION_ET = 1023;
+const unsigned int MAX_EM_RANK = 63;
+
+// Random numbers which only depend on the seed and the event number.  The
+// std distributions are implementation defined, so they are not used.
+class Random {
+  public:
+    Random(uint32_t seed, uint64_t eventNumber) {
+      std::seed_seq seq = { seed, uint32_t(eventNumber), uint32_t(eventNumber >> 32) };
+      engine_.seed(seq);
+    }
+    // In (0, 1).
+    double flat() { return (engine_() + 0.5) / 4294967296.; }
+    double exponential(double mean) { return -mean * std::log(flat()); }
+    double flat(double min, double max) { return min + (max - min) * flat(); }
+    // In [0, n).
+    unsigned int below(unsigned int n) { return unsigned(flat() * n); }
+  private:
+    std::mt19937 engine_;
+};
+
+// Add ET (in region ET units) to a region, ignoring positions outside the
+// calorimeter in eta.  Phi wraps around.
+void deposit(unsigned int* et, int eta, int phi, double regionEt) {
+  if (eta < 0 || eta >= uctgrid::N_ETA)
+    return;
+  phi = (phi + uctgrid::N_PHI) % uctgrid::N_PHI;
+  et[uctgrid::index(eta, phi)] += unsigned(regionEt + 0.5);
+}
+
+// Skip white space and comments.
+size_t skipSpace(const std::string& text, size_t pos) {
+  while (pos < text.size()) {
+    if (text[pos] == '#') {
+      pos = text.find('\n', pos);
+      if (pos == std::string::npos)
+        return text.size();
+    } else if (!std::isspace((unsigned char) text[pos])) {
+      break;
+    }
+    ++pos;
+  }
+  return pos;
+}
+
+}
+
+UCTEventGenerator::Config::Config() :
+  fixedPU(0),
+  puOccupancyScale(50),
+  emCandFraction(0.1),
+  tauVetoFraction(0.1),
+  mipFraction(0.05),
+  nJets(0),
+  nTaus(0),
+  nElectrons(0),
+  minInjectedEt(20),
+  maxInjectedEt(100),
+  regionLSB(0.5),
+  egLSB(1.0),
+  seed(1) {}
+
+UCTEventGenerator::UCTEventGenerator(const Config& config) :
+  config_(config) {
+  double total = 0;
+  for (size_t i = 0; i < config_.puProfile.size(); ++i) {
+    total += config_.puProfile[i];
+    puCumulative_.push_back(total);
+  }
+  for (size_t i = 0; i < puCumulative_.size(); ++i)
+    puCumulative_[i] /= total;
+}
+
+double UCTEventGenerator::expectedOccupancy(unsigned int nPU) const {
+  return uctgrid::N_CELLS * (1 - std::exp(-(nPU / config_.puOccupancyScale)));
+}
+
+void UCTEventGenerator::generate(uint64_t eventNumber, Event* event) const {
+  Random random(config_.seed, eventNumber);
+
+  event->nPU = config_.fixedPU;
+  if (!puCumulative_.empty()) {
+    event->nPU = std::lower_bound(puCumulative_.begin(), puCumulative_.end() - 1,
+        random.flat()) - puCumulative_.begin();
+  }
+
+  // The PUM0 bin the event will end up in, and the mean pileup ET per
+  // region of every eta in that bin.
+  double occupied = expectedOccupancy(event->nPU);
+  int pumBin = std::min(N_PUM_BINS - 1, UCTRegionCorrectionTable::pumBin(unsigned(occupied)));
+  double meanEt[uctgrid::N_ETA];
+  for (int eta = 0; eta < uctgrid::N_ETA; ++eta) {
+    meanEt[eta] = 1.0;
+    if (!config_.regionSubtraction.empty()) {
+      // The highest bins are empty in some tables, for lack of events; use
+      // the highest filled one below.
+      meanEt[eta] = 0;
+      for (int bin = pumBin; bin >= 0 && meanEt[eta] == 0; --bin) {
+        unsigned int i = N_PUM_BINS * eta + bin;
+        if (i < config_.regionSubtraction.size())
+          meanEt[eta] = config_.regionSubtraction[i];
+      }
+    }
+    // Even the quietest eta gets a share of the hits.
+    meanEt[eta] = std::max(meanEt[eta], 0.01);
+  }
+
+  // Share the occupied regions out between the etas in proportion to
+  // meanEt, filling up any eta which would be more than fully occupied.
+  double occupancy[uctgrid::N_ETA] = { 0 };
+  bool full[uctgrid::N_ETA] = { false };
+  double remaining = occupied / uctgrid::N_PHI;
+  while (remaining > 1e-9) {
+    double sumWeights = 0;
+    for (int eta = 0; eta < uctgrid::N_ETA; ++eta) {
+      if (!full[eta])
+        sumWeights += meanEt[eta];
+    }
+    if (sumWeights == 0)
+      break;
+    double scale = remaining / sumWeights;
+    remaining = 0;
+    for (int eta = 0; eta < uctgrid::N_ETA; ++eta) {
+      if (full[eta])
+        continue;
+      occupancy[eta] += scale * meanEt[eta];
+      if (occupancy[eta] >= 1) {
+        remaining += occupancy[eta] - 1;
+        occupancy[eta] = 1;
+        full[eta] = true;
+      }
+    }
+  }
+
+  // Pileup.  The mean ET of an occupied region is the mean per region
+  // divided by the occupancy.
+  unsigned int et[uctgrid::N_CELLS] = { 0 };
+  for (int eta = 0; eta < uctgrid::N_ETA; ++eta) {
+    if (occupancy[eta] == 0)
+      continue;
+    double meanOccupiedEt = std::max(meanEt[eta] / occupancy[eta], config_.regionLSB);
+    for (int phi = 0; phi < uctgrid::N_PHI; ++phi) {
+      if (random.flat() < occupancy[eta]) {
+        double regionEt = random.exponential(meanOccupiedEt) / config_.regionLSB;
+        et[uctgrid::index(eta, phi)] = std::max(1u, unsigned(regionEt + 0.5));
+      }
+    }
+  }
+
+  // Injected objects.  Their EM candidates go first, so they are the ones
+  // found by the region correction.
+  event->emCands.clear();
+  bool hasEmCand[uctgrid::N_CELLS] = { false };
+  bool narrow[uctgrid::N_CELLS] = { false };
+  for (unsigned int i = 0; i < config_.nJets; ++i) {
+    int eta = random.below(uctgrid::N_ETA);
+    int phi = random.below(uctgrid::N_PHI);
+    double jetEt = random.flat(config_.minInjectedEt, config_.maxInjectedEt) / config_.regionLSB;
+    // 60% in the centre, the rest spread over the 3x3.
+    deposit(et, eta, phi, 0.6 * jetEt);
+    for (int dEta = -1; dEta <= 1; ++dEta) {
+      for (int dPhi = -1; dPhi <= 1; ++dPhi) {
+        if (dEta != 0 || dPhi != 0)
+          deposit(et, eta + dEta, phi + dPhi, 0.05 * jetEt);
+      }
+    }
+  }
+  for (unsigned int i = 0; i < config_.nTaus + config_.nElectrons; ++i) {
+    bool electron = i >= config_.nTaus;
+    unsigned int eta = MIN_CENTRAL_ETA + random.below(MAX_CENTRAL_ETA - MIN_CENTRAL_ETA + 1);
+    unsigned int phi = random.below(uctgrid::N_PHI);
+    double objectEt = random.flat(config_.minInjectedEt, config_.maxInjectedEt);
+    int cell = uctgrid::index(eta, phi);
+    double emEt = 0;
+    if (electron) {
+      deposit(et, eta, phi, objectEt / config_.regionLSB);
+      emEt = objectEt;
+    } else {
+      // 85% in the centre, the rest in one of the neighbours, and a
+      // neutral pion half the time.
+      unsigned int neighbour = random.below(8);
+      neighbour += neighbour >= 4;
+      deposit(et, eta, phi, 0.85 * objectEt / config_.regionLSB);
+      deposit(et, eta + int(neighbour / 3) - 1, phi + int(neighbour % 3) - 1,
+          0.15 * objectEt / config_.regionLSB);
+      if (random.flat() < 0.5)
+        emEt = 0.3 * objectEt;
+    }
+    narrow[cell] = true;
+    if (emEt > 0 && !hasEmCand[cell]) {
+      uctcore::EmCand cand;
+      cand.rank = std::min(MAX_EM_RANK, std::max(1u, unsigned(emEt / config_.egLSB + 0.5)));
+      cand.gctEta = eta;
+      cand.gctPhi = phi;
+      cand.rctEta = uctgrid::rctEta(eta);
+      cand.rctPhi = uctgrid::rctPhi(phi);
+      cand.isolated = electron;
+      event->emCands.push_back(cand);
+      hasEmCand[cell] = true;
+    }
+  }
+
+  event->regions.clear();
+  event->regions.reserve(uctgrid::N_CELLS);
+  for (int cell = 0; cell < uctgrid::N_CELLS; ++cell) {
+    uctcore::Region region = uctcore::Region();
+    region.gctEta = cell / uctgrid::N_PHI;
+    region.gctPhi = cell % uctgrid::N_PHI;
+    region.rctEta = uctgrid::rctEta(region.gctEta);
+    region.rctPhi = uctgrid::rctPhi(region.gctPhi);
+    region.et = std::min(et[cell], MAX_REGION_ET);
+    region.overFlow = et[cell] > MAX_REGION_ET;
+    bool central = region.gctEta >= MIN_CENTRAL_ETA && region.gctEta <= MAX_CENTRAL_ETA;
+    if (region.et > 0) {
+      bool veto = random.flat() < config_.tauVetoFraction && !narrow[cell];
+      if (central)
+        region.tauVeto = veto;
+      else
+        region.fineGrain = veto;
+      region.mip = random.flat() < config_.mipFraction;
+    }
+    event->regions.push_back(region);
+
+    if (central && region.et > 0 && !hasEmCand[cell] &&
+        random.flat() < config_.emCandFraction) {
+      // Half of the region ET in the 2x1.
+      double emEt = 0.5 * region.et * config_.regionLSB;
+      uctcore::EmCand cand;
+      cand.rank = std::min(MAX_EM_RANK, std::max(1u, unsigned(emEt / config_.egLSB + 0.5)));
+      cand.gctEta = region.gctEta;
+      cand.gctPhi = region.gctPhi;
+      cand.rctEta = region.rctEta;
+      cand.rctPhi = region.rctPhi;
+      cand.isolated = random.flat() < 0.5;
+      event->emCands.push_back(cand);
+    }
+  }
+}
+
+bool UCTEventGenerator::readCfiVDouble(std::istream& in,
+    const std::string& name, std::vector<double>* values) {
+  const std::string text((std::istreambuf_iterator<char>(in)),
+      std::istreambuf_iterator<char>());
+
+  // name = ..., at the start of a line
+  size_t pos = 0;
+  while (true) {
+    pos = text.find(name, pos);
+    if (pos == std::string::npos)
+      return false;
+    size_t next = pos + name.size();
+    while (next < text.size() && (text[next] == ' ' || text[next] == '\t'))
+      ++next;
+    if ((pos == 0 || text[pos - 1] == '\n') && next < text.size() && text[next] == '=') {
+      pos = next + 1;
+      break;
+    }
+    pos = next;
+  }
+
+  static const std::string vdouble = "cms.vdouble(";
+  values->clear();
+  while (true) {
+    pos = skipSpace(text, pos);
+    if (text.compare(pos, vdouble.size(), vdouble) != 0)
+      return false;
+    pos += vdouble.size();
+    while (true) {
+      pos = skipSpace(text, pos);
+      if (pos >= text.size())
+        return false;
+      if (text[pos] == ')') {
+        ++pos;
+        break;
+      }
+      if (text[pos] == ',') {
+        ++pos;
+        continue;
+      }
+      const char* start = text.c_str() + pos;
+      char* end;
+      double value = std::strtod(start, &end);
+      if (end == start)
+        return false;
+      values->push_back(value);
+      pos += end - start;
+    }
+    // Another vdouble added on?
+    size_t next = skipSpace(text, pos);
+    if (next >= text.size() || text[next] != '+')
+      return true;
+    pos = next + 1;
+  }
+}
@@ -0,0 +1,101 @@
+#ifndef UCTEVENTGENERATOR_K3VD8QMS
+#define UCTEVENTGENERATOR_K3VD8QMS
+
+/*
+ * =====================================================================================
+ *
+ *       Filename:  UCTEventGenerator.h
+ *
+ *    Description:  Synthetic RCT regions and EM candidates for a given
+ *                  pileup profile, without GEN-SIM or the RCT emulator.
+ *
+ *                  The pileup is modelled on a regionSubtraction table
+ *                  (regionSF_cfi.py): the number of interactions sets the
+ *                  number of occupied regions and so the PUM0 bin, and the
+ *                  table entries of that bin, which are the mean pileup ET
+ *                  per region, give the share of the occupied regions and
+ *                  the mean ET of each gctEta.  The PUM0 subtraction with
+ *                  the same table therefore removes about the mean pileup
+ *                  ET of the events.  Jets, taus and electrons can be
+ *                  added on top.
+ *
+ *                  Only the standard library is used; see
+ *                  UCTCoreAdapters.h for the framework collections.
+ *
+ * =====================================================================================
+ */
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "L1Trigger/UCT2015/interface/UCTCoreTypes.h"
+
+class UCTEventGenerator {
+  public:
+    struct Config {
+      Config();
+
+      // Mean pileup ET per region in physical ET, 18 PUM0 bins per gctEta,
+      // like regionSubtraction.  Empty means 1 GeV everywhere.
+      std::vector<double> regionSubtraction;
+      // Probability of 0, 1, 2... interactions, like the probValue of the
+      // mixing module.  Empty means always fixedPU.
+      std::vector<double> puProfile;
+      unsigned int fixedPU;
+      // Number of interactions at which 1 - 1/e of the regions are
+      // occupied.
+      double puOccupancyScale;
+
+      // Fraction of the occupied barrel and endcap regions with an EM
+      // candidate, and of all occupied regions with the tau veto (fine
+      // grain in HF) or MIP bit set.
+      double emCandFraction;
+      double tauVetoFraction;
+      double mipFraction;
+
+      // Objects added to every event, with a flat ET spectrum in GeV.
+      unsigned int nJets;
+      unsigned int nTaus;
+      unsigned int nElectrons;
+      double minInjectedEt;
+      double maxInjectedEt;
+
+      double regionLSB;
+      double egLSB;
+
+      uint32_t seed;
+    };
+
+    struct Event {
+      std::vector<uctcore::Region> regions;
+      std::vector<uctcore::EmCand> emCands;
+      // Number of pileup interactions drawn for the event.
+      unsigned int nPU;
+    };
+
+    explicit UCTEventGenerator(const Config& config);
+
+    // Generate the event with the given number into event, reusing its
+    // storage.  An event only depends on the seed and its number, so events
+    // can be generated in any order, by any number of streams, and come out
+    // the same on every platform.
+    void generate(uint64_t eventNumber, Event* event) const;
+
+    // Expected number of occupied regions for nPU interactions.
+    double expectedOccupancy(unsigned int nPU) const;
+
+    // Read the vdouble called name from a python configuration fragment
+    // such as regionSF_cfi.py, where it may be written as several
+    // cms.vdouble(...) added together.  Returns false if it is not there.
+    static bool readCfiVDouble(std::istream& in, const std::string& name,
+        std::vector<double>* values);
+
+  private:
+    Config config_;
+    // Cumulative puProfile, normalized to 1.
+    std::vector<double> puCumulative_;
+};
+
+#endif /* end of include guard: UCTEVENTGENERATOR_K3VD8QMS */
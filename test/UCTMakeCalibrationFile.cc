@@ -0,0 +1,108 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  UCTMakeCalibrationFile.cc
+ *
+ *    Description:  Writes the cms.vdouble tables of python configuration
+ *                  fragments (regionSF_cfi.py, jetSF_cfi.py) to a binary
+ *                  calibration file (see UCTCalibrationFile.h), or lists
+ *                  the tables of one.
+ *
+ *                  UCTMakeCalibrationFile out.bin fragment_cfi.py...
+ *                  UCTMakeCalibrationFile -l file.bin
+ *
+ *                  Every top level "name = cms.vdouble(...)" of the
+ *                  fragments becomes a table called name.  The file is
+ *                  replaced in one step, so it can be rewritten under a
+ *                  running job.
+ *
+ * =====================================================================================
+ */
+
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "L1Trigger/UCT2015/interface/UCTCalibrationFile.h"
+#include "L1Trigger/UCT2015/test/UCTEventGenerator.h"
+
+namespace {
+
+// Names assigned a cms.vdouble at the start of a line.
+std::vector<std::string> vdoubleNames(const std::string& text) {
+  std::vector<std::string> names;
+  std::istringstream lines(text);
+  std::string line;
+  while (std::getline(lines, line)) {
+    size_t end = 0;
+    while (end < line.size() && (std::isalnum((unsigned char) line[end]) || line[end] == '_'))
+      ++end;
+    if (end == 0)
+      continue;
+    size_t pos = line.find_first_not_of(" \t", end);
+    if (pos == std::string::npos || line[pos] != '=')
+      continue;
+    pos = line.find_first_not_of(" \t", pos + 1);
+    if (pos != std::string::npos && line.compare(pos, 12, "cms.vdouble(") == 0)
+      names.push_back(line.substr(0, end));
+  }
+  return names;
+}
+
+int list(const char* fileName) {
+  uctcalib::File file;
+  std::string error;
+  if (!file.open(fileName, &error)) {
+    std::fprintf(stderr, "%s\n", error.c_str());
+    return 1;
+  }
+  std::printf("%s: checksum %08x\n", fileName, file.checksum());
+  for (size_t t = 0; t < file.nTables(); ++t)
+    std::printf("  %-40s %u values\n", file.entry(t).name, file.entry(t).count);
+  return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  if (argc == 3 && std::strcmp(argv[1], "-l") == 0)
+    return list(argv[2]);
+  if (argc < 3) {
+    std::fprintf(stderr, "usage: %s out.bin fragment_cfi.py...\n"
+        "       %s -l file.bin\n", argv[0], argv[0]);
+    return 2;
+  }
+
+  uctcalib::TableList tables;
+  for (int i = 2; i < argc; ++i) {
+    std::ifstream in(argv[i]);
+    if (!in) {
+      std::fprintf(stderr, "cannot read %s\n", argv[i]);
+      return 1;
+    }
+    std::string text((std::istreambuf_iterator<char>(in)),
+        std::istreambuf_iterator<char>());
+    std::vector<std::string> names = vdoubleNames(text);
+    for (size_t n = 0; n < names.size(); ++n) {
+      std::istringstream fragment(text);
+      std::vector<double> values;
+      if (!UCTEventGenerator::readCfiVDouble(fragment, names[n], &values)) {
+        std::fprintf(stderr, "cannot parse %s in %s\n", names[n].c_str(), argv[i]);
+        return 1;
+      }
+      tables.push_back(std::make_pair(names[n], values));
+      std::printf("%-40s %zu values\n", names[n].c_str(), values.size());
+    }
+  }
+
+  std::string error;
+  if (!uctcalib::write(argv[1], tables, &error)) {
+    std::fprintf(stderr, "%s\n", error.c_str());
+    return 1;
+  }
+  return 0;
+}
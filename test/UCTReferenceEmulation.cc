@@ -0,0 +1,768 @@
+#include "L1Trigger/UCT2015/test/UCTReferenceEmulation.h"
+#include "L1Trigger/UCT2015/interface/UCTCore.h"
+#include "L1Trigger/UCT2015/interface/helpers.h"
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <math.h>
+
+using uctcore::Candidate;
+using uctcore::Config;
+using uctcore::EmCand;
+using uctcore::Region;
+
+namespace uctref {
+
+namespace {
+
+const unsigned int N_PHI = 18;
+const unsigned int N_ETA = 22;
+
+// deltaPhiWrapAtN from helpers.cc, which needs the framework.
+int deltaPhiWrapAtN(unsigned int N, int phi1, int phi2) {
+  int difference = phi1 - phi2;
+  if (std::abs(phi1 - phi2) == int(N-1)) {
+    difference = -difference/std::abs(difference);
+  }
+  return difference;
+}
+
+int deltaGctPhi(const Region& r1, const Region& r2) {
+  return deltaPhiWrapAtN(18, r1.gctPhi, r2.gctPhi);
+}
+
+// The UCT2015Producer member functions, with its members.
+class Emulator {
+  public:
+    Emulator(const Config& config, const std::vector<Region>& regions,
+        const std::vector<EmCand>& emCands, unsigned int puLevelPUM0,
+        Output* output);
+
+    void puSubtraction();
+    void makeSums();
+    void makeJets();
+    CandidateList correctJets(const CandidateList& jets, bool isJet);
+    void makeEGTaus();
+    void makeTaus();
+
+  private:
+    double egPhysicalEt(const EmCand& cand) const {
+      return config_.egLSB*cand.rank;
+    }
+
+    double regionPhysicalEt(const Region& cand) const {
+      return std::max(0.,config_.regionLSB*cand.et);
+    }
+
+    void findAnnulusInfo(int ieta, int iphi,
+        const std::vector<Region>& regions,
+        double* associatedSecondRegionEt,
+        double* associatedThirdRegionEt,
+        unsigned int* mipsInAnnulus,
+        unsigned int* egFlagsInAnnulus,
+        unsigned int* mipInSecondRegion) const;
+
+    const Config& config_;
+    const std::vector<Region>& newRegions;
+    const std::vector<EmCand>& newEMCands;
+    Output& out_;
+
+    unsigned int puLevelPUM0;
+    int puLevelHIHI[N_ETA];
+
+    unsigned int sumET;
+    int sumEx;
+    int sumEy;
+    unsigned int MET;
+
+    unsigned int sumHT;
+    int sumHx;
+    int sumHy;
+    unsigned int MHT;
+
+    std::vector<double> sinPhi;
+    std::vector<double> cosPhi;
+};
+
+Emulator::Emulator(const Config& config, const std::vector<Region>& regions,
+    const std::vector<EmCand>& emCands, unsigned int puLevelPUM0,
+    Output* output) :
+  config_(config), newRegions(regions), newEMCands(emCands), out_(*output),
+  puLevelPUM0(puLevelPUM0) {
+  out_.puLevelHI = 0;
+  out_.puLevelHIUIC = 0;
+  for(unsigned i = 0; i < N_ETA; ++i)
+    puLevelHIHI[i] = 0;
+  for(unsigned int i = 0; i < N_PHI; i++) {
+    sinPhi.push_back(sin(2. * 3.1415927 * i * 1.0 / N_PHI));
+    cosPhi.push_back(cos(2. * 3.1415927 * i * 1.0 / N_PHI));
+  }
+}
+
+void Emulator::puSubtraction()
+{
+  unsigned int& puLevelHI = out_.puLevelHI;
+  unsigned int& puLevelHIUIC = out_.puLevelHIUIC;
+  puLevelHI = 0;
+  puLevelHIUIC = 0;
+  double r_puLevelHIUIC=0.0;
+  double r_puLevelHIHI[N_ETA];
+
+  int etaCount[N_ETA];
+  for(unsigned i = 0; i < N_ETA; ++i)
+    {
+      puLevelHIHI[i] = 0;
+      r_puLevelHIHI[i] = 0.0;
+      etaCount[i] = 0;
+    }
+
+  int puCount = 0;
+  double Rarea=0.0;
+  for(std::vector<Region>::const_iterator newRegion = newRegions.begin();
+      newRegion != newRegions.end(); newRegion++){
+    if(regionPhysicalEt(*newRegion) <= config_.puETMax) {
+      puLevelHI += newRegion->et; puCount++;
+      r_puLevelHIUIC += newRegion->et;
+      Rarea += getRegionArea(newRegion->gctEta);
+    }
+    r_puLevelHIHI[newRegion->gctEta] += newRegion->et;
+    etaCount[newRegion->gctEta]++;
+  } //end regionforloop
+  // Add a factor of 9, so it corresponds to a jet.  Reduces roundoff error.
+  puLevelHI *= 9;
+  if(puCount != 0) puLevelHI = puLevelHI / puCount;
+  r_puLevelHIUIC = r_puLevelHIUIC / Rarea;
+  puLevelHIUIC=0;
+  if (r_puLevelHIUIC > 0.) puLevelHIUIC = floor (r_puLevelHIUIC + 0.5);
+
+  for(unsigned i = 0; i < N_ETA; ++i)
+    {
+      puLevelHIHI[i] = floor(r_puLevelHIHI[i]/etaCount[i] + 0.5);
+    }
+}
+
+void Emulator::makeSums()
+{
+  sumET = 0;
+  sumEx = 0;
+  sumEy = 0;
+  sumHT = 0;
+  sumHx = 0;
+  sumHy = 0;
+
+  for(std::vector<Region>::const_iterator newRegion = newRegions.begin();
+      newRegion != newRegions.end(); newRegion++){
+    // Remove forward stuff
+    if (newRegion->gctEta < config_.minGctEtaForSums || newRegion->gctEta > config_.maxGctEtaForSums) {
+      continue;
+    }
+
+    double regionET =  regionPhysicalEt(*newRegion);
+
+    if(regionET >= config_.regionETCutForMET){
+      sumET += regionET;
+      sumEx += (int) (((double) regionET) * cosPhi[newRegion->gctPhi]);
+      sumEy += (int) (((double) regionET) * sinPhi[newRegion->gctPhi]);
+    }
+    if(regionET >= config_.regionETCutForHT) {
+      sumHT += regionET;
+      sumHx += (int) (((double) regionET) * cosPhi[newRegion->gctPhi]);
+      sumHy += (int) (((double) regionET) * sinPhi[newRegion->gctPhi]);
+    }
+    else if(regionET >= config_.regionETCutForNeighbor) {
+      bool goodNeighbor = false;
+      for(std::vector<Region>::const_iterator neighbor = newRegions.begin();
+          neighbor != newRegions.end(); neighbor++) {
+        if((deltaGctPhi(*newRegion, *neighbor) == 1 && (newRegion->gctEta == neighbor->gctEta)) ||
+           (deltaGctPhi(*newRegion, *neighbor) == -1 && (newRegion->gctEta == neighbor->gctEta)) ||
+           (deltaGctPhi(*newRegion, *neighbor) == 0 && (newRegion->gctEta - neighbor->gctEta) == 1) ||
+           (deltaGctPhi(*newRegion, *neighbor) == 0 && (neighbor->gctEta - newRegion->gctEta) == 1)) {
+          double neighborET = regionPhysicalEt(*neighbor);
+          if(neighborET >= config_.regionETCutForHT) {
+            goodNeighbor = true;
+          }
+        }
+      }
+      if(goodNeighbor ) {
+        sumHT += regionET;
+        sumHx += (int) (((double) regionET) * cosPhi[newRegion->gctPhi]);
+        sumHy += (int) (((double) regionET) * sinPhi[newRegion->gctPhi]);
+      }
+    }
+  }
+  MET = ((unsigned int) sqrt(sumEx * sumEx + sumEy * sumEy));
+  MHT = ((unsigned int) sqrt(sumHx * sumHx + sumHy * sumHy));
+
+  double physicalPhi = atan2(sumEy, sumEx) + 3.1415927;
+  unsigned int iPhi = N_PHI * physicalPhi / (2 * 3.1415927);
+  out_.METObject = Candidate(MET, 0, physicalPhi);
+  out_.METObject.setInt(uctkey::rgnPhi, iPhi);
+  out_.METObject.setInt(uctkey::rank, MET);
+
+  double physicalPhiHT = atan2(sumHy, sumHx) + 3.1415927;
+  iPhi = N_PHI * (physicalPhiHT) / (2 * 3.1415927);
+  out_.MHTObject = Candidate(MHT, 0, physicalPhiHT);
+  out_.MHTObject.setInt(uctkey::rgnPhi, iPhi);
+  out_.MHTObject.setInt(uctkey::rank, MHT);
+
+  out_.SETObject = Candidate(sumET, 0, 0);
+  out_.SETObject.setInt(uctkey::rank, sumET);
+
+  out_.SHTObject = Candidate(sumHT, 0, 0);
+  out_.SHTObject.setInt(uctkey::rank, sumHT);
+}
+
+void Emulator::makeJets() {
+  bool subtractHI = config_.puCorrectHI && config_.useHI;
+  CandidateList& jetList = out_.jetList;
+  jetList.clear();
+  for(std::vector<Region>::const_iterator newRegion = newRegions.begin();
+      newRegion != newRegions.end(); newRegion++) {
+    double regionET = regionPhysicalEt(*newRegion);
+    if(subtractHI)
+      regionET = std::max(0.,regionET -
+                          (puLevelHIHI[newRegion->gctEta]*config_.regionLSB));
+    if((regionET > config_.jetSeed) || subtractHI) {
+      double neighborN_et = 0;
+      double neighborS_et = 0;
+      double neighborE_et = 0;
+      double neighborW_et = 0;
+      double neighborNE_et = 0;
+      double neighborSW_et = 0;
+      double neighborNW_et = 0;
+      double neighborSE_et = 0;
+      unsigned int nNeighbors = 0;
+      for(std::vector<Region>::const_iterator neighbor = newRegions.begin();
+          neighbor != newRegions.end(); neighbor++) {
+        double neighborET = regionPhysicalEt(*neighbor);
+        if(deltaGctPhi(*newRegion, *neighbor) == 1 &&
+           (newRegion->gctEta    ) == neighbor->gctEta) {
+          neighborN_et = neighborET;
+          if(subtractHI)
+            neighborN_et = std::max(0.,neighborET -
+                                    (puLevelHIHI[neighbor->gctEta]*config_.regionLSB));
+          nNeighbors++;
+          continue;
+        }
+        else if(deltaGctPhi(*newRegion, *neighbor) == -1 &&
+                (newRegion->gctEta    ) == neighbor->gctEta) {
+          neighborS_et = neighborET;
+          if(subtractHI)
+            neighborS_et = std::max(0.,neighborET -
+                                    (puLevelHIHI[neighbor->gctEta]*config_.regionLSB));
+          nNeighbors++;
+          continue;
+        }
+        else if(deltaGctPhi(*newRegion, *neighbor) == 0 &&
+                (newRegion->gctEta + 1) == neighbor->gctEta) {
+          neighborE_et = neighborET;
+          if(subtractHI)
+            neighborE_et = std::max(0.,neighborET -
+                                    (puLevelHIHI[neighbor->gctEta]*config_.regionLSB));
+          nNeighbors++;
+          continue;
+        }
+        else if(deltaGctPhi(*newRegion, *neighbor) == 0 &&
+                (newRegion->gctEta - 1) == neighbor->gctEta) {
+          neighborW_et = neighborET;
+          if(subtractHI)
+            neighborW_et = std::max(0.,neighborET -
+                                    (puLevelHIHI[neighbor->gctEta]*config_.regionLSB));
+          nNeighbors++;
+          continue;
+        }
+        else if(deltaGctPhi(*newRegion, *neighbor) == 1 &&
+                (newRegion->gctEta + 1) == neighbor->gctEta) {
+          neighborNE_et = neighborET;
+          if(subtractHI)
+            neighborNE_et = std::max(0.,neighborET -
+                                     (puLevelHIHI[neighbor->gctEta]*config_.regionLSB));
+          nNeighbors++;
+          continue;
+        }
+        else if(deltaGctPhi(*newRegion, *neighbor) == -1 &&
+                (newRegion->gctEta - 1) == neighbor->gctEta) {
+          neighborSW_et = neighborET;
+          if(subtractHI)
+            neighborSW_et = std::max(0.,neighborET -
+                                     (puLevelHIHI[neighbor->gctEta]*config_.regionLSB));
+          nNeighbors++;
+          continue;
+        }
+        else if(deltaGctPhi(*newRegion, *neighbor) == 1 &&
+                (newRegion->gctEta - 1) == neighbor->gctEta) {
+          neighborNW_et = neighborET;
+          if(subtractHI)
+            neighborNW_et = std::max(0.,neighborET -
+                                     (puLevelHIHI[neighbor->gctEta]*config_.regionLSB));
+          nNeighbors++;
+          continue;
+        }
+        else if(deltaGctPhi(*newRegion, *neighbor) == -1 &&
+                (newRegion->gctEta + 1) == neighbor->gctEta) {
+          neighborSE_et = neighborET;
+          if(subtractHI)
+            neighborSE_et = std::max(0.,neighborET -
+                                     (puLevelHIHI[neighbor->gctEta]*config_.regionLSB));
+          nNeighbors++;
+          continue;
+        }
+      }
+      if(regionET > neighborN_et &&
+         regionET > neighborNW_et &&
+         regionET > neighborW_et &&
+         regionET > neighborSW_et &&
+         regionET >= neighborNE_et &&
+         regionET >= neighborE_et &&
+         regionET >= neighborSE_et &&
+         regionET >= neighborS_et) {
+        unsigned int jetET = regionET +
+          neighborN_et + neighborS_et + neighborE_et + neighborW_et +
+          neighborNE_et + neighborSW_et + neighborSE_et + neighborNW_et;
+
+        // Temporarily use the region granularity
+        int jetPhi = newRegion->gctPhi;
+        int jetEta = newRegion->gctEta;
+
+        bool neighborCheck = (nNeighbors == 8);
+        // On the eta edge we only expect 5 neighbors
+        if (!neighborCheck && (jetEta == 0 || jetEta == 21) && nNeighbors == 5)
+          neighborCheck = true;
+
+        if (!neighborCheck) {
+          std::cout << "phi: " << jetPhi << " eta: " << jetEta << " n: " << nNeighbors << std::endl;
+          std::cout << "JetPt: " << jetET << " regionET: " << regionET << std::endl;
+          assert(false);
+        }
+        Candidate theJet(jetET, convertRegionEta(jetEta), convertRegionPhi(jetPhi));
+        theJet.setInt(uctkey::rgnEta, jetEta);
+        theJet.setInt(uctkey::rgnPhi, jetPhi);
+        theJet.setInt(uctkey::rctEta, newRegion->rctEta);
+        theJet.setInt(uctkey::rctPhi, newRegion->rctPhi);
+        theJet.setInt(uctkey::rank, jetET);
+
+        theJet.setInt(uctkey::neighborNW_et, neighborNW_et);
+        theJet.setInt(uctkey::neighborW_et, neighborW_et);
+        theJet.setInt(uctkey::neighborSW_et, neighborSW_et);
+        theJet.setInt(uctkey::neighborNE_et, neighborNE_et);
+        theJet.setInt(uctkey::neighborE_et, neighborE_et);
+        theJet.setInt(uctkey::neighborSE_et, neighborSE_et);
+        theJet.setInt(uctkey::neighborN_et, neighborN_et);
+        theJet.setInt(uctkey::neighborS_et, neighborS_et);
+        theJet.setInt(uctkey::jetseed_et, regionET);
+
+        // Embed the puLevelHI information in the jet object for later tuning
+        theJet.setFloat(uctkey::puLevelPUM0, puLevelPUM0);
+        theJet.setFloat(uctkey::puLevelHI, out_.puLevelHI);
+        theJet.setFloat(uctkey::puLevelHIUIC, out_.puLevelHIUIC);
+        // Store information about the "core" PT of the jet (central region)
+        theJet.setFloat(uctkey::associatedRegionEt, regionET);
+        jetList.push_back(theJet);
+      }
+    }
+  }
+  jetList.sort();
+  jetList.reverse();
+}
+
+CandidateList Emulator::correctJets(const CandidateList& jets, bool isJet) {
+  // jet corrections only valid if PU density has been calculated
+  CandidateList corrlist;
+  if (!config_.applyJetCalibration) {corrlist=jets; return corrlist;}
+
+  for(CandidateList::const_iterator jet = jets.begin(); jet != jets.end(); jet++) {
+    const double jetET=jet->pt();
+    double alpha = config_.jetSF[2*jet->getInt(uctkey::rgnEta) + 0]; //Scale factor (See jetSF_cfi.py)
+    double gamma = ((config_.jetSF[2*jet->getInt(uctkey::rgnEta) + 1])); //Offset
+
+    double jpt = jetET*alpha+gamma;
+    unsigned int corjetET =(int) jpt;
+
+    Candidate newJet(corjetET, convertRegionEta(jet->getInt(uctkey::rgnEta)), convertRegionPhi(jet->getInt(uctkey::rgnPhi)));
+    newJet.setFloat(uctkey::uncorrectedPt, jetET);
+    newJet.setInt(uctkey::rgnEta, jet->getInt(uctkey::rgnEta));
+    newJet.setInt(uctkey::rgnPhi, jet->getInt(uctkey::rgnPhi));
+    newJet.setInt(uctkey::rctEta, jet->getInt(uctkey::rctEta));
+    newJet.setInt(uctkey::rctPhi, jet->getInt(uctkey::rctPhi));
+    newJet.setInt(uctkey::rank, corjetET);
+
+    if(isJet){
+      newJet.setInt(uctkey::jetseed_et, jet->getInt(uctkey::jetseed_et));
+      newJet.setInt(uctkey::neighborNW_et, jet->getInt(uctkey::neighborNW_et));
+      newJet.setInt(uctkey::neighborN_et, jet->getInt(uctkey::neighborN_et));
+      newJet.setInt(uctkey::neighborNE_et, jet->getInt(uctkey::neighborNE_et));
+      newJet.setInt(uctkey::neighborW_et, jet->getInt(uctkey::neighborW_et));
+      newJet.setInt(uctkey::neighborE_et, jet->getInt(uctkey::neighborE_et));
+      newJet.setInt(uctkey::neighborSW_et, jet->getInt(uctkey::neighborSW_et));
+      newJet.setInt(uctkey::neighborS_et, jet->getInt(uctkey::neighborS_et));
+      newJet.setInt(uctkey::neighborSE_et, jet->getInt(uctkey::neighborSE_et));
+    }
+    newJet.setFloat(uctkey::puLevelPUM0, puLevelPUM0);
+    newJet.setFloat(uctkey::puLevelHI, out_.puLevelHI);
+    newJet.setFloat(uctkey::puLevelHIUIC, out_.puLevelHIUIC);
+
+    corrlist.push_back(newJet);
+  }
+
+  corrlist.sort();
+  corrlist.reverse();
+
+  return corrlist;
+}
+
+// Given a region at iphi/ieta, find the highest region in the surrounding
+// regions.
+void Emulator::findAnnulusInfo(int ieta, int iphi,
+    const std::vector<Region>& regions,
+    double* associatedSecondRegionEt,
+    double* associatedThirdRegionEt,
+    unsigned int* mipsInAnnulus,
+    unsigned int* egFlagsInAnnulus,
+    unsigned int* mipInSecondRegion) const {
+
+  unsigned int neighborsFound = 0;
+  unsigned int mipsCount = 0;
+  unsigned int egFlagCount = 0;
+  double highestNeighborEt = 0;
+  // We don't want to count the contribution of the highest neighbor, this allows
+  // us to subtract off the highest neighbor at the end, so we only loop once.
+  bool highestNeighborHasMip = false;
+  bool highestNeighborHasEGFlag = false;
+  double secondNeighborEt = 0;
+
+  for(std::vector<Region>::const_iterator region = regions.begin();
+      region != regions.end(); region++) {
+    int regionPhi = region->gctPhi;
+    int regionEta = region->gctEta;
+    unsigned int deltaPhi = std::abs(deltaPhiWrapAtN(18, iphi, regionPhi));
+    unsigned int deltaEta = std::abs(ieta - regionEta);
+    if ((deltaPhi + deltaEta) > 0 && deltaPhi < 2 && deltaEta < 2) {
+      double regionET = regionPhysicalEt(*region);
+      if (regionET > highestNeighborEt) {
+        if(highestNeighborEt!=0) secondNeighborEt=highestNeighborEt;
+        highestNeighborEt = regionET;
+        // Keep track of what flags the highest neighbor has
+        highestNeighborHasMip = region->mip;
+        highestNeighborHasEGFlag = !region->mip && !region->tauVeto;
+      }
+
+      // count how many neighbors pass the flags.
+      if (region->mip) {
+        mipsCount++;
+      }
+      if (!region->mip && !region->tauVeto) {
+        egFlagCount++;
+      }
+
+      // If we already found all 8 neighbors, we don't need to keep looping
+      // over the regions.
+      neighborsFound++;
+      if (neighborsFound == 8) {
+        break;
+      }
+    }
+  }
+  // check if we need to remove the highest neighbor from the flag count.
+  if (highestNeighborHasMip)
+    mipsCount--;
+  if (highestNeighborHasEGFlag)
+    egFlagCount--;
+
+  // set output
+  *associatedSecondRegionEt = highestNeighborEt;
+  *associatedThirdRegionEt =secondNeighborEt;
+  *mipsInAnnulus = mipsCount;
+  *mipInSecondRegion = highestNeighborHasMip;
+  *egFlagsInAnnulus = egFlagCount;
+}
+
+void Emulator::makeEGTaus() {
+  CandidateList& rlxTauList = out_.rlxTauList;
+  CandidateList& isoTauList = out_.isoTauList;
+  CandidateList& rlxEGList = out_.rlxEGList;
+  CandidateList& isoEGList = out_.isoEGList;
+  rlxTauList.clear();
+  isoTauList.clear();
+  rlxEGList.clear();
+  isoEGList.clear();
+  for(std::vector<EmCand>::const_iterator egtCand = newEMCands.begin();
+      egtCand != newEMCands.end(); egtCand++){
+    double et = egPhysicalEt(*egtCand);
+    if(et > config_.egtSeed) {
+
+      for(std::vector<Region>::const_iterator region = newRegions.begin();
+          region != newRegions.end(); region++) {
+        if(egtCand->gctPhi == region->gctPhi &&
+           egtCand->gctEta == region->gctEta)
+          {
+            double regionEt = regionPhysicalEt(*region);
+
+            bool isEle=false;
+            if(et<40 && (!region->tauVeto && !region->mip )) isEle=true;
+            if(et>=40 && et<63 && (!region->mip )) isEle=true;
+            if(et>=63) isEle=true;
+
+            isEle=true;  // Lets rescue the old LUT
+
+            // Find the highest region in the 3x3 annulus around the center
+            // region.
+            double associatedSecondRegionEt = 0;
+            double associatedThirdRegionEt = 0;
+            unsigned int mipsInAnnulus = 0;
+            unsigned int egFlagsInAnnulus = 0;
+            unsigned int mipInSecondRegion = 0;
+            findAnnulusInfo(
+                egtCand->gctEta, egtCand->gctPhi,
+                newRegions,
+                &associatedSecondRegionEt, &associatedThirdRegionEt, &mipsInAnnulus, &egFlagsInAnnulus,
+                &mipInSecondRegion);
+
+            Candidate egtauCand(
+                et,
+                convertRegionEta(egtCand->gctEta),
+                convertRegionPhi(egtCand->gctPhi));
+
+            // Add extra information to the candidate
+            egtauCand.setInt(uctkey::rgnEta, egtCand->gctEta);
+            egtauCand.setInt(uctkey::rgnPhi, egtCand->gctPhi);
+            egtauCand.setInt(uctkey::rctEta, egtCand->rctEta);
+            egtauCand.setInt(uctkey::rctPhi, egtCand->rctPhi);
+            egtauCand.setInt(uctkey::rank, egtCand->rank);
+            egtauCand.setFloat(uctkey::associatedJetPt, -3);
+            egtauCand.setFloat(uctkey::associatedRegionEt, regionEt);
+            egtauCand.setFloat(uctkey::associatedSecondRegionEt, associatedSecondRegionEt);
+            egtauCand.setInt(uctkey::associatedSecondRegionMIP, mipInSecondRegion);
+            egtauCand.setFloat(uctkey::puLevelHI, out_.puLevelHI);
+            egtauCand.setFloat(uctkey::puLevelHIUIC, out_.puLevelHIUIC);
+            egtauCand.setFloat(uctkey::puLevelPUM0,puLevelPUM0);
+            egtauCand.setInt(uctkey::ellIsolation, egtCand->isolated);
+            egtauCand.setInt(uctkey::tauVeto, region->tauVeto);
+            egtauCand.setInt(uctkey::mipBit, region->mip);
+            egtauCand.setInt(uctkey::isEle, isEle);
+
+            // A 2x1 and 1x2 cluster above egtSeed is always in tau list
+            rlxTauList.push_back(egtauCand);
+
+            // Note tauVeto now refers to emActivity pattern veto;
+            // Good patterns are from EG candidates
+            if (isEle){
+              rlxEGList.push_back(egtauCand);
+            }
+
+            // Look for overlapping jet and require that isolation be passed
+            bool MATCHEDJETFOUND_=false;
+            for(CandidateList::iterator jet = out_.jetList.begin(); jet != out_.jetList.end(); jet++) {
+
+              if((int)egtCand->gctPhi == jet->getInt(uctkey::rgnPhi) &&
+                 (int)egtCand->gctEta == jet->getInt(uctkey::rgnEta)) {
+                // Embed tuning parameters into the relaxed objects
+                rlxTauList.back().setFloat(uctkey::associatedJetPt, jet->pt());
+
+                MATCHEDJETFOUND_=true;
+
+                // EG ID enabled! MC
+                if (isEle){
+                  rlxEGList.back().setFloat(uctkey::associatedJetPt, jet->pt());
+                  bool isHighPtEle=true;
+                  if(jet->pt()>2*regionEt) isHighPtEle=false;
+                  rlxEGList.back().setInt(uctkey::isHighPtEle,isHighPtEle);
+                }
+
+                double jetIsolation = jet->pt() - regionEt;        // Jet isolation
+                double relativeJetIsolation = jetIsolation / regionEt;
+                // A 2x1 and 1x2 cluster above egtSeed passing relative isolation will be in tau list
+                if(relativeJetIsolation < config_.relativeTauIsolationCut || regionEt > config_.switchOffTauIso){
+                  isoTauList.push_back(rlxTauList.back());
+                }
+                double jetIsolationEG = jet->pt() - et;        // Jet isolation
+                double relativeJetIsolationEG = jetIsolationEG / et;
+
+                bool isolatedEG=false;
+                if(et<63 && relativeJetIsolationEG < config_.relativeJetIsolationCut)  isolatedEG=true;;
+                if (et>=63) isolatedEG=true;;
+
+                if(isEle){
+                  rlxEGList.back().setInt(uctkey::isIsolated,isolatedEG);
+                  if(isolatedEG){
+                    isoEGList.push_back(rlxEGList.back());
+                  }
+                }
+                break;
+              }
+            }
+            if(!MATCHEDJETFOUND_ && isEle) {
+              rlxEGList.back().setFloat(uctkey::associatedJetPt,-777);
+              rlxEGList.back().setInt(uctkey::isHighPtEle,true);
+              rlxEGList.back().setInt(uctkey::isIsolated,true);
+              isoEGList.push_back(rlxEGList.back());
+            }
+            break;
+          }
+      }
+    }
+  }
+  rlxEGList.sort();
+  rlxTauList.sort();
+  isoEGList.sort();
+  isoTauList.sort();
+  rlxEGList.reverse();
+  rlxTauList.reverse();
+  isoEGList.reverse();
+  isoTauList.reverse();
+}
+
+void Emulator::makeTaus() {
+  CandidateList& rlxTauRegionOnlyList = out_.rlxTauRegionOnlyList;
+  CandidateList& isoTauRegionOnlyList = out_.isoTauRegionOnlyList;
+  rlxTauRegionOnlyList.clear();
+  isoTauRegionOnlyList.clear();
+  for(std::vector<Region>::const_iterator region = newRegions.begin();
+      region != newRegions.end(); region++) {
+    double regionEt = regionPhysicalEt(*region);
+    if(regionEt<config_.tauSeed) continue;
+
+    double associatedSecondRegionEt = 0;
+    double associatedThirdRegionEt = 0;
+    unsigned int mipsInAnnulus = 0;
+    unsigned int egFlagsInAnnulus = 0;
+    unsigned int mipInSecondRegion = 0;
+    findAnnulusInfo(
+        region->gctEta, region->gctPhi,
+        newRegions,
+        &associatedSecondRegionEt, &associatedThirdRegionEt,  &mipsInAnnulus, &egFlagsInAnnulus,
+        &mipInSecondRegion);
+
+    double tauEt=regionEt;
+
+    Candidate tauCand(
+        tauEt,
+        convertRegionEta(region->gctEta),
+        convertRegionPhi(region->gctPhi));
+
+    tauCand.setInt(uctkey::gctEta, region->gctEta);
+    tauCand.setInt(uctkey::gctPhi, region->gctPhi);
+    tauCand.setInt(uctkey::rgnEta, region->gctEta);
+    tauCand.setInt(uctkey::rgnPhi, region->gctPhi);
+    tauCand.setInt(uctkey::rctEta, region->rctEta);
+    tauCand.setInt(uctkey::rctPhi, region->rctPhi);
+    tauCand.setFloat(uctkey::associatedJetPt, -3);
+    tauCand.setFloat(uctkey::associatedRegionEt, regionEt);
+    tauCand.setFloat(uctkey::puLevelHI, out_.puLevelHI);
+    tauCand.setFloat(uctkey::puLevelHIUIC, out_.puLevelHIUIC);
+    tauCand.setFloat(uctkey::puLevelPUM0,puLevelPUM0);
+    tauCand.setInt(uctkey::tauVeto, region->tauVeto);
+    tauCand.setInt(uctkey::mipBit, region->mip);
+    tauCand.setFloat(uctkey::associatedSecondRegionEt, associatedSecondRegionEt);
+    tauCand.setInt(uctkey::associatedSecondRegionMIP, mipInSecondRegion);
+    tauCand.setFloat(uctkey::associatedThirdRegionEt, associatedThirdRegionEt);
+
+    rlxTauRegionOnlyList.push_back(tauCand);
+
+    bool MATCHEDJETFOUND_=false;
+    // Look for overlapping jet and require that isolation be passed
+    for(CandidateList::iterator jet = out_.jetList.begin(); jet != out_.jetList.end(); jet++) {
+      if((int)region->gctPhi == jet->getInt(uctkey::rgnPhi) &&
+         (int)region->gctEta == jet->getInt(uctkey::rgnEta)) {
+        MATCHEDJETFOUND_=true;
+        rlxTauRegionOnlyList.back().setFloat(uctkey::associatedJetPt, jet->pt());
+
+        double jetIsolation = jet->pt() - regionEt;        // Jet isolation
+        double relativeJetIsolation = jetIsolation / regionEt;
+        if(relativeJetIsolation < config_.relativeTauIsolationCut || regionEt > config_.switchOffTauIso){
+          isoTauRegionOnlyList.push_back(rlxTauRegionOnlyList.back());
+        }
+
+        break;
+      }
+    }
+    if(!MATCHEDJETFOUND_){
+      rlxTauRegionOnlyList.back().setFloat(uctkey::associatedJetPt, -777);
+      isoTauRegionOnlyList.push_back(rlxTauRegionOnlyList.back());
+    }
+  }
+  rlxTauRegionOnlyList.sort();
+  isoTauRegionOnlyList.sort();
+  rlxTauRegionOnlyList.reverse();
+  isoTauRegionOnlyList.reverse();
+}
+
+} // namespace
+
+void emulate(const Config& config, const std::vector<Region>& regions,
+    const std::vector<EmCand>& emCands, unsigned int puLevelPUM0,
+    Output* output) {
+  Emulator emulator(config, regions, emCands, puLevelPUM0, output);
+  if(config.puCorrectHI) emulator.puSubtraction();
+  emulator.makeSums();
+  emulator.makeJets();
+  output->corrJetList = emulator.correctJets(output->jetList, true);
+  emulator.makeEGTaus();
+  emulator.makeTaus();
+}
+
+void correctRegions(const std::vector<double>& regionSF,
+    const std::vector<double>& regionSubtraction,
+    bool applyCalibration, bool puMultCorrect,
+    const std::vector<Region>& regions,
+    const std::vector<EmCand>& emCands,
+    std::vector<Region>* corrected, int* pumBin) {
+  unsigned int puMult = 0;
+  //This calulates PUM0
+  for(std::vector<Region>::const_iterator notCorrectedRegion = regions.begin();
+      notCorrectedRegion != regions.end(); notCorrectedRegion++){
+    double regionET = notCorrectedRegion->et;
+    if (regionET > 0) {puMult++;}
+  }
+  int pumbin = (int) puMult/22; //396 Regions. Bins are 22 wide. Dividing by 22 gives which bin# of the 18 bins.
+
+  corrected->clear();
+  for(std::vector<Region>::const_iterator notCorrectedRegion = regions.begin();
+      notCorrectedRegion != regions.end(); notCorrectedRegion++){
+    double regionET = notCorrectedRegion->et;
+    unsigned int regionEta = notCorrectedRegion->gctEta;
+
+    int regionEtCorr=0;
+
+    // Only non-empty regions are corrected
+    if(regionET!=0) {
+      double energyECAL2x1=0;
+      // Find associated 2x1 ECAL energy (EG are calibrated, we should not scale them up, it affects the isolation routines)
+      // 2x1 regions have the MAX tower contained in the 4x4 region that its position points to.
+      // This is to not break isolation.
+      for(std::vector<EmCand>::const_iterator egtCand = emCands.begin(); egtCand != emCands.end(); egtCand++){
+        double et = egtCand->rank;
+        if(egtCand->gctPhi == notCorrectedRegion->gctPhi && egtCand->gctEta == notCorrectedRegion->gctEta) {
+          energyECAL2x1=et;
+          break;
+        }
+      }
+
+      unsigned int iSF = 2*regionEta;
+      double alpha = iSF < regionSF.size() ? regionSF[iSF + 0] : 0; //Region Scale factor (See regionSF_cfi.py)
+      double gamma = iSF + 1 < regionSF.size() ? 2*((regionSF[iSF + 1])/3) : 0; //Region Offset.
+      if(!applyCalibration || regionET<20) {alpha=1;  gamma=0;}
+
+      unsigned int iSub = 18*regionEta+pumbin;
+      double puSub = iSub < regionSubtraction.size() ? regionSubtraction[iSub]*2 : 0;
+      if(!puMultCorrect) puSub=0;
+
+      if(regionET - puSub<1) {regionEtCorr =0 ;}
+      else {
+        double pum0pt =  (int) (regionET - puSub-energyECAL2x1); //subtract ECAl energy
+        double corrpum0pt = pum0pt*alpha+gamma+energyECAL2x1; //add back in ECAL energy, calibrate regions(not including the ECAL2x1).
+
+        if (corrpum0pt<0) {corrpum0pt=0;} //zero floor
+
+        regionEtCorr = (int) (corrpum0pt);
+      }
+    }
+
+    Region out = *notCorrectedRegion;
+    out.et = regionEtCorr;
+    corrected->push_back(out);
+  }
+  *pumBin = pumbin;
+}
+
+} // namespace uctref
@@ -0,0 +1,69 @@
+#ifndef UCTREFERENCEEMULATION_T7XB2KQE
+#define UCTREFERENCEEMULATION_T7XB2KQE
+
+/*
+ * =====================================================================================
+ *
+ *       Filename:  UCTReferenceEmulation.h
+ *
+ *    Description:  The UCT2015Producer and RegionCorrection algorithms as
+ *                  originally written (lists, a scan over every region for
+ *                  each neighbour, runtime sin/cos), on the plain types of
+ *                  the emulation core.  Slow on purpose: it is the
+ *                  reference the optimized code in UCTCore.h must agree
+ *                  with bit for bit (see test/UCTDiffHarness.cc).  Only
+ *                  the double arithmetic path is covered;
+ *                  useFixedPointSumsAndJetSF is ignored.
+ *
+ * =====================================================================================
+ */
+
+#include <list>
+#include <vector>
+
+#include "L1Trigger/UCT2015/interface/UCTCoreTypes.h"
+
+namespace uctcore {
+struct Config;
+}
+
+namespace uctref {
+
+typedef std::list<uctcore::Candidate> CandidateList;
+
+// The UCT2015Producer outputs, in the order they are put in the event.
+struct Output {
+  unsigned int puLevelHI;
+  unsigned int puLevelHIUIC;
+
+  uctcore::Candidate METObject;
+  uctcore::Candidate MHTObject;
+  uctcore::Candidate SETObject;
+  uctcore::Candidate SHTObject;
+
+  CandidateList jetList, corrJetList;
+  CandidateList rlxTauList, isoTauList;
+  CandidateList rlxEGList, isoEGList;
+  CandidateList rlxTauRegionOnlyList, isoTauRegionOnlyList;
+};
+
+// UCT2015Producer::produce on the given regions and EM candidates.
+// puLevelPUM0 is the PUM0 bin of the region correction, or -1.
+void emulate(const uctcore::Config& config,
+    const std::vector<uctcore::Region>& regions,
+    const std::vector<uctcore::EmCand>& emCands,
+    unsigned int puLevelPUM0, Output* output);
+
+// RegionCorrection::produce: the corrected regions, in the same order, and
+// the PUM0 bin.  Constants past the end of regionSF or regionSubtraction
+// read as 0, as in UCTRegionCorrectionTable.
+void correctRegions(const std::vector<double>& regionSF,
+    const std::vector<double>& regionSubtraction,
+    bool applyCalibration, bool puMultCorrect,
+    const std::vector<uctcore::Region>& regions,
+    const std::vector<uctcore::EmCand>& emCands,
+    std::vector<uctcore::Region>* corrected, int* pumBin);
+
+} // namespace uctref
+
+#endif /* end of include guard: UCTREFERENCEEMULATION_T7XB2KQE */
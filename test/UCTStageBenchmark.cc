@@ -0,0 +1,313 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  UCTStageBenchmark.cc
+ *
+ *    Description:  Times every stage of the UCT emulation core (UCTCore.h)
+ *                  on synthetic events at fixed pileup points, and prints
+ *                  one CSV line per (stage, PU) with the time, heap
+ *                  allocations and output candidates per event.
+ *
+ *                  UCTStageBenchmark [-n events] [-r repeats] [-s seed] [-a]
+ *                                    [-t regionSF_cfi.py] [-p table]
+ *
+ *                  -a builds the candidate collections in the per-event
+ *                  arena, as with useEventArena.  The events come from
+ *                  UCTEventGenerator, with one jet, tau and electron each.
+ *                  With -t, the regionSubtraction table called -p
+ *                  (regionSubtraction_PU40_MC13TeV by default) is read from
+ *                  the given file and used for both the generation and the
+ *                  PUM0 subtraction; otherwise a flat table is used.
+ *
+ * =====================================================================================
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#include "L1Trigger/UCT2015/interface/UCTCore.h"
+#include "L1Trigger/UCT2015/test/UCTEventGenerator.h"
+#include "L1Trigger/UCT2015/interface/UCTRegionCorrectionTable.h"
+
+// Every heap allocation of the process goes through here, so that the
+// stages can be charged for theirs.
+static unsigned long nAllocations = 0;
+
+void* operator new(size_t size) {
+  ++nAllocations;
+  void* p = std::malloc(size ? size : 1);
+  if (!p)
+    throw std::bad_alloc();
+  return p;
+}
+
+void* operator new[](size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+  std::free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+  std::free(p);
+}
+
+namespace {
+
+const unsigned int puPoints[] = { 0, 20, 40, 80, 140, 200 };
+const unsigned int N_PU_POINTS = sizeof(puPoints) / sizeof(puPoints[0]);
+
+// The emulation_cfi.py defaults, with a flat jet calibration.
+uctcore::Config makeConfig() {
+  uctcore::Config config;
+  config.puCorrectHI = false;
+  config.applyJetCalibration = true;
+  config.useHI = false;
+  config.puETMax = 7;
+  config.regionETCutForHT = 7;
+  config.regionETCutForNeighbor = 3;
+  config.regionETCutForMET = 0;
+  config.minGctEtaForSums = 4;
+  config.maxGctEtaForSums = 17;
+  config.jetSeed = 10;
+  config.tauSeed = 7;
+  config.egtSeed = 2;
+  config.relativeTauIsolationCut = 1.0;
+  config.relativeJetIsolationCut = 0.5;
+  config.switchOffTauIso = 100;
+  config.egLSB = 1.0;
+  config.regionLSB = 0.5;
+  for (int eta = 0; eta < uctgrid::N_ETA; ++eta) {
+    config.jetSF.push_back(1.1);
+    config.jetSF.push_back(2.0);
+  }
+  config.deriveConstants();
+  return config;
+}
+
+enum Stage {
+  kRegionCorrection,
+  kPUEstimate,
+  kGrid,
+  kAnnulus,
+  kSums,
+  kJets,
+  kJetCalibration,
+  kEGTaus,
+  kRegionTaus,
+  kGctTranslation,
+  N_STAGES
+};
+
+const char* stageNames[N_STAGES] = {
+  "RegionCorrection", "PUEstimate", "Grid", "Annulus", "Sums", "Jets",
+  "JetCalibration", "EGTaus", "RegionTaus", "GctTranslation"
+};
+
+struct StageStats {
+  double ns;
+  unsigned long allocations;
+  unsigned long candidates;
+};
+
+// What UCT2015GctCandsProducer does with the first four objects of each
+// collection, minus the ES scales.
+unsigned long translateToGct(const uctcore::EventState& state,
+    unsigned int* checksum) {
+  unsigned long n = 0;
+  const uctcore::CandidateBuffer* emLists[2] = { &state.rlxEGList, &state.isoEGList };
+  for (int l = 0; l < 2; ++l) {
+    for (size_t i = 0; i < emLists[l]->size() && i < 4; ++i, ++n) {
+      const uctcore::Candidate& eg = (*emLists[l])[i];
+      *checksum += unsigned(uctcore::gctSaturatedEgEt(eg.pt(), true)) +
+        uctcore::gctEmEta(eg.rgnEta(), eg.rctEta());
+    }
+  }
+  const uctcore::CandidateBuffer* jetLists[2] = { &state.isoTauRegionOnlyList, &state.corrJetList };
+  for (int l = 0; l < 2; ++l) {
+    for (size_t i = 0; i < jetLists[l]->size() && i < 4; ++i, ++n) {
+      const uctcore::Candidate& jet = (*jetLists[l])[i];
+      *checksum += uctcore::gctJetEta(jet.rgnEta(), jet.rctEta()) +
+        uctcore::gctJetPhi(jet.rgnPhi()) + uctcore::gctIsForwardJet(jet.rctEta());
+    }
+  }
+  *checksum += uctcore::gctSumRank(state.SETObject.pt(), 0.5) +
+    uctcore::gctSumRank(state.SHTObject.pt(), 0.5) +
+    uctcore::gctMETPhi(state.METObject.phi() - M_PI) +
+    uctcore::gctMHTPhi(state.MHTObject.phi() - M_PI);
+  return n + 4;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  unsigned int nEvents = 200;
+  unsigned int nRepeats = 5;
+  unsigned int seed = 12345;
+  bool useEventArena = false;
+  const char* tableFile = 0;
+  std::string tableName = "regionSubtraction_PU40_MC13TeV";
+  int opt;
+  while ((opt = getopt(argc, argv, "n:r:s:at:p:")) != -1) {
+    switch (opt) {
+      case 'n': nEvents = std::atoi(optarg); break;
+      case 'r': nRepeats = std::max(1, std::atoi(optarg)); break;
+      case 's': seed = std::atoi(optarg); break;
+      case 'a': useEventArena = true; break;
+      case 't': tableFile = optarg; break;
+      case 'p': tableName = optarg; break;
+      default:
+        std::fprintf(stderr, "usage: %s [-n events] [-r repeats] [-s seed] [-a]"
+            " [-t regionSF_cfi.py] [-p table]\n", argv[0]);
+        return 1;
+    }
+  }
+
+  const uctcore::Config config = makeConfig();
+  // PUM0 subtraction from the cfi, or a flat 0.5 GeV per bin.  No
+  // calibration.
+  std::vector<double> regionSubtraction(18 * uctgrid::N_ETA);
+  for (size_t i = 0; i < regionSubtraction.size(); ++i)
+    regionSubtraction[i] = 0.5 * (i % 18);
+  if (tableFile) {
+    std::ifstream in(tableFile);
+    if (!UCTEventGenerator::readCfiVDouble(in, tableName, &regionSubtraction)) {
+      std::fprintf(stderr, "no %s in %s\n", tableName.c_str(), tableFile);
+      return 1;
+    }
+  }
+  UCTRegionCorrectionTable correctionTable;
+  std::string error;
+  if (!correctionTable.build(std::vector<double>(), regionSubtraction, false, true, &error)) {
+    std::fprintf(stderr, "%s: %s\n", tableFile, error.c_str());
+    return 1;
+  }
+
+  std::printf("stage,pu,events,ns_per_event,allocs_per_event,cands_per_event\n");
+
+  UCTEventGenerator::Config generatorConfig;
+  generatorConfig.regionSubtraction = regionSubtraction;
+  generatorConfig.nJets = 1;
+  generatorConfig.nTaus = 1;
+  generatorConfig.nElectrons = 1;
+  generatorConfig.regionLSB = config.regionLSB;
+  generatorConfig.egLSB = config.egLSB;
+  generatorConfig.seed = seed;
+
+  unsigned int checksum = 0;
+  for (unsigned int p = 0; p < N_PU_POINTS; ++p) {
+    generatorConfig.fixedPU = puPoints[p];
+    UCTEventGenerator generator(generatorConfig);
+    std::vector<UCTEventGenerator::Event> events(nEvents);
+    for (unsigned int i = 0; i < nEvents; ++i)
+      generator.generate(i, &events[i]);
+
+    uctcore::EventState state(useEventArena);
+    StageStats stats[N_STAGES] = {};
+    std::vector<uctcore::Region> corrected;
+
+    for (unsigned int repeat = 0; repeat <= nRepeats; ++repeat) {
+      // The first pass warms up the buffers and is not counted.
+      bool record = repeat > 0;
+      for (unsigned int i = 0; i < events.size(); ++i) {
+        const UCTEventGenerator::Event& event = events[i];
+        state.regions = event.regions;
+        state.emCands = event.emCands;
+
+        for (int stage = 0; stage < N_STAGES; ++stage) {
+          unsigned long allocationsBefore = nAllocations;
+          std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+          unsigned long candidates = 0;
+          switch (stage) {
+            case kRegionCorrection: {
+              int pumBin = UCTRegionCorrectionTable::pumBin(uctcore::puMultiplicity(state.regions));
+              uctcore::correctRegions(correctionTable, state.regions, state.emCands,
+                  pumBin, &corrected);
+              state.puLevelPUM0 = pumBin;
+              candidates = corrected.size();
+              break;
+            }
+            case kPUEstimate:
+              uctcore::estimatePU(config, state);
+              break;
+            case kGrid:
+              state.regionGrid.fill(state.regions, config.regionLSB);
+              break;
+            case kAnnulus:
+              state.annulusCache.build(state.regions, state.regionGrid);
+              break;
+            case kSums:
+              uctcore::makeSums(config, state);
+              candidates = 4;
+              break;
+            case kJets:
+              uctcore::makeJets(config, state);
+              candidates = state.jetList.size();
+              break;
+            case kJetCalibration:
+              uctcore::calibrateJets(config, state);
+              candidates = state.corrJetList.size();
+              break;
+            case kEGTaus:
+              uctcore::makeEGTaus(config, state);
+              candidates = state.rlxEGList.size() + state.isoEGList.size() +
+                state.rlxTauList.size() + state.isoTauList.size();
+              break;
+            case kRegionTaus:
+              uctcore::makeTaus(config, state);
+              candidates = state.rlxTauRegionOnlyList.size() +
+                state.isoTauRegionOnlyList.size();
+              break;
+            case kGctTranslation:
+              candidates = translateToGct(state, &checksum);
+              break;
+          }
+          std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+          if (record) {
+            stats[stage].ns += std::chrono::duration<double, std::nano>(stop - start).count();
+            stats[stage].allocations += nAllocations - allocationsBefore;
+            stats[stage].candidates += candidates;
+          }
+        }
+
+        // End of event, as in UCT2015Producer::produce.
+        uctcore::CandidateBuffer* buffers[] = {
+          &state.jetList, &state.corrJetList, &state.rlxTauList,
+          &state.corrRlxTauList, &state.rlxEGList, &state.isoTauList,
+          &state.corrIsoTauList, &state.isoEGList,
+          &state.rlxTauRegionOnlyList, &state.isoTauRegionOnlyList
+        };
+        for (size_t b = 0; b < sizeof(buffers) / sizeof(buffers[0]); ++b)
+          buffers[b]->discard();
+        state.eventArena.reset();
+      }
+    }
+
+    double nRecorded = double(nEvents) * nRepeats;
+    for (int stage = 0; stage < N_STAGES; ++stage) {
+      std::printf("%s,%u,%.0f,%.1f,%.2f,%.2f\n", stageNames[stage], puPoints[p],
+          nRecorded, stats[stage].ns / nRecorded,
+          stats[stage].allocations / nRecorded,
+          stats[stage].candidates / nRecorded);
+    }
+  }
+  // Keeps the translation from being optimized away.
+  std::fprintf(stderr, "checksum %u\n", checksum);
+  return 0;
+}
@@ -0,0 +1,86 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  UCTSyntheticDigis.cc
+ *
+ *    Description:  Puts synthetic RCT regions and EM candidates (see
+ *                  UCTEventGenerator.h) in the event, in place of uctDigis,
+ *                  so that RegionCorrection and UCT2015Producer can be run
+ *                  on any number of pileup events from an EmptySource.
+ *
+ * =====================================================================================
+ */
+
+#include <memory>
+#include <vector>
+
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/global/EDProducer.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+#include "DataFormats/L1CaloTrigger/interface/L1CaloCollections.h"
+#include "DataFormats/L1CaloTrigger/interface/L1CaloRegion.h"
+#include "DataFormats/L1CaloTrigger/interface/L1CaloEmCand.h"
+
+#include "L1Trigger/UCT2015/test/UCTEventGenerator.h"
+#include "L1Trigger/UCT2015/interface/UCTCoreAdapters.h"
+
+class UCTSyntheticDigis : public edm::global::EDProducer<> {
+  public:
+    explicit UCTSyntheticDigis(const edm::ParameterSet& pset);
+    virtual void produce(edm::StreamID, edm::Event& evt, const edm::EventSetup& es) const;
+  private:
+    static UCTEventGenerator::Config makeConfig(const edm::ParameterSet& pset);
+    UCTEventGenerator generator_;
+};
+
+UCTEventGenerator::Config UCTSyntheticDigis::makeConfig(const edm::ParameterSet& pset) {
+  UCTEventGenerator::Config config;
+  config.regionSubtraction = pset.getParameter<std::vector<double> >("regionSubtraction");
+  config.puProfile = pset.getParameter<std::vector<double> >("puProfile");
+  config.fixedPU = pset.getParameter<unsigned int>("fixedPU");
+  config.puOccupancyScale = pset.getParameter<double>("puOccupancyScale");
+  config.emCandFraction = pset.getParameter<double>("emCandFraction");
+  config.tauVetoFraction = pset.getParameter<double>("tauVetoFraction");
+  config.mipFraction = pset.getParameter<double>("mipFraction");
+  config.nJets = pset.getParameter<unsigned int>("nJets");
+  config.nTaus = pset.getParameter<unsigned int>("nTaus");
+  config.nElectrons = pset.getParameter<unsigned int>("nElectrons");
+  config.minInjectedEt = pset.getParameter<double>("minInjectedEt");
+  config.maxInjectedEt = pset.getParameter<double>("maxInjectedEt");
+  config.regionLSB = pset.getParameter<double>("regionLSB");
+  config.egLSB = pset.getParameter<double>("egammaLSB");
+  config.seed = pset.getParameter<unsigned int>("seed");
+  return config;
+}
+
+UCTSyntheticDigis::UCTSyntheticDigis(const edm::ParameterSet& pset) :
+  generator_(makeConfig(pset)) {
+  produces<L1CaloRegionCollection>();
+  produces<L1CaloEmCollection>();
+}
+
+void UCTSyntheticDigis::produce(edm::StreamID, edm::Event& evt, const edm::EventSetup& es) const {
+  // Keyed on the run and event number, so the output does not depend on
+  // which stream gets the event.
+  uint64_t eventNumber = (uint64_t(evt.id().run()) << 32) | evt.id().event();
+  UCTEventGenerator::Event event;
+  generator_.generate(eventNumber, &event);
+
+  std::auto_ptr<L1CaloRegionCollection> regions(new L1CaloRegionCollection);
+  regions->reserve(event.regions.size());
+  for (size_t i = 0; i < event.regions.size(); ++i)
+    regions->push_back(uctcore::makeL1CaloRegion(event.regions[i]));
+
+  std::auto_ptr<L1CaloEmCollection> emCands(new L1CaloEmCollection);
+  emCands->reserve(event.emCands.size());
+  for (size_t i = 0; i < event.emCands.size(); ++i)
+    emCands->push_back(uctcore::makeL1CaloEmCand(event.emCands[i]));
+
+  evt.put(regions);
+  evt.put(emCands);
+}
+
+DEFINE_FWK_MODULE(UCTSyntheticDigis);
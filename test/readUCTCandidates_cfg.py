@@ -0,0 +1,31 @@
+#!/usr/bin/env cmsRun
+#flake8: noqa
+'''
+
+Check the UCTCandidates in a file written with writeUCTCandidates_cfg.py.
+
+Usage:
+
+    cmsRun readUCTCandidates_cfg.py inputFiles=file:uctCandidates.root
+
+'''
+
+import FWCore.ParameterSet.Config as cms
+
+from FWCore.ParameterSet.VarParsing import VarParsing
+options = VarParsing ('analysis')
+options.parseArguments()
+
+process = cms.Process("UCTCandidateIORead")
+
+process.source = cms.Source(
+    "PoolSource",
+    fileNames = cms.untracked.vstring(options.inputFiles)
+)
+
+process.checkUCTCandidates = cms.EDAnalyzer(
+    "UCTCandidateIOReader",
+    src = cms.InputTag("uctCandidates")
+)
+
+process.p = cms.Path(process.checkUCTCandidates)
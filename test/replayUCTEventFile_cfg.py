@@ -0,0 +1,74 @@
+#!/usr/bin/env cmsRun
+#flake8: noqa
+'''
+
+Run the UCT emulation on RCT regions and EM candidates recorded with
+runRCTEmulatorOn2012DataTPGs.py eventFile=...
+
+Usage:
+
+    cmsRun replayUCTEventFile_cfg.py eventFile=uct_events.bin maxEvents=1000
+
+maxEvents must not be larger than the number of recorded events.
+
+'''
+
+import FWCore.ParameterSet.Config as cms
+
+# Get command line options
+from FWCore.ParameterSet.VarParsing import VarParsing
+options = VarParsing ('analysis')
+options.register(
+    'eventFile',
+    'uct_events.bin',
+    VarParsing.multiplicity.singleton,
+    VarParsing.varType.string,
+    "File written by UCTEventFileWriter")
+options.outputFile = "uct_replay.root"
+options.register(
+    'fuseRegionCorrection',
+    0,
+    VarParsing.multiplicity.singleton,
+    VarParsing.varType.int,
+    "Do the region correction in UCT2015Producer instead of CorrectedDigis")
+options.parseArguments()
+
+process = cms.Process("L1UCTReplay")
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(options.maxEvents)
+)
+
+process.source = cms.Source("EmptySource")
+
+process.load("L1Trigger.UCT2015.emulation_cfi")
+from L1Trigger.UCT2015.uctEventFile_cfi import uctRecordedDigis
+process.uctDigis = uctRecordedDigis.clone(
+    fileName = options.eventFile,
+    replayInOrder = True
+)
+
+if options.fuseRegionCorrection:
+    from L1Trigger.UCT2015.emulation_cfi import fuseRegionCorrection
+    fuseRegionCorrection(process)
+    process.p1 = cms.Path(process.uctDigis * process.UCT2015Producer)
+else:
+    process.p1 = cms.Path(
+        process.uctDigis
+        * process.CorrectedDigis
+        * process.UCT2015Producer
+    )
+
+process.out = cms.OutputModule(
+      "PoolOutputModule"
+      , fileName       = cms.untracked.string(options.outputFile)
+      , outputCommands = cms.untracked.vstring('drop *', 'keep *_UCT2015Producer_*_*')
+)
+
+process.outpath = cms.EndPath(
+      process.out
+)
+
+# Make the framework shut up.
+process.load("FWCore.MessageLogger.MessageLogger_cfi")
+process.MessageLogger.cerr.FwkReport.reportEvery = 1000
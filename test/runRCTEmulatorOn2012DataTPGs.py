@@ -22,6 +22,19 @@ options = VarParsing ('analysis')
 # Set useful defaults
 options.inputFiles = '/store/user/tapas/2012-08-01-CRAB_ZEESkim/skim_10_1_wd2.root'
 options.outputFile = "uct_rate_tree.root"
+options.register(
+    'eventFile',
+    '',
+    VarParsing.multiplicity.singleton,
+    VarParsing.varType.string,
+    "Also record the RCT regions and EM candidates to this file, for"
+    " replayUCTEventFile_cfg.py")
+options.register(
+    'fuseRegionCorrection',
+    0,
+    VarParsing.multiplicity.singleton,
+    VarParsing.varType.int,
+    "Do the region correction in UCT2015Producer instead of CorrectedDigis")
 options.parseArguments()
 
 process = cms.Process("L1UCTTest")
@@ -50,10 +63,19 @@ process.load("L1Trigger.UCT2015.emulation_cfi")
 process.load("EventFilter.ScalersRawToDigi.ScalersRawToDigi_cfi")
 process.scalersRawToDigi.scalersInputTag = 'rawDataCollector'
 
+if options.fuseRegionCorrection:
+    from L1Trigger.UCT2015.emulation_cfi import fuseRegionCorrection
+    fuseRegionCorrection(process)
+
 process.p1 = cms.Path(
     process.emulationSequence
 )
 
+if options.eventFile:
+    process.load("L1Trigger.UCT2015.uctEventFile_cfi")
+    process.uctEventFileWriter.fileName = options.eventFile
+    process.p1 += process.uctEventFileWriter
+
 process.out = cms.OutputModule(
       "PoolOutputModule"
       , fileName       = cms.untracked.string(options.outputFile)
@@ -0,0 +1,18 @@
+#!/bin/sh
+# Write UCTCandidates with this release and read them back, then read the
+# reference files written with older UCTCandidate class versions.
+set -e
+cd ${LOCAL_TMP_DIR:-.}
+cmsRun ${LOCAL_TEST_DIR}/writeUCTCandidates_cfg.py outputFile=uctCandidates_current.root
+cmsRun ${LOCAL_TEST_DIR}/readUCTCandidates_cfg.py inputFiles=file:uctCandidates_current.root
+nRead=0
+for reference in ${LOCAL_TEST_DIR}/data/uctCandidates_v*.root; do
+  [ -e "$reference" ] || continue
+  echo "Reading $reference"
+  cmsRun ${LOCAL_TEST_DIR}/readUCTCandidates_cfg.py inputFiles=file:$reference
+  nRead=$((nRead + 1))
+done
+if [ $nRead -eq 0 ]; then
+  echo "No reference files in ${LOCAL_TEST_DIR}/data"
+  exit 1
+fi
@@ -0,0 +1,42 @@
+#!/usr/bin/env cmsRun
+#flake8: noqa
+'''
+
+Write the UCTCandidates of UCTCandidateIOWriter to a file, to be read back
+with readUCTCandidates_cfg.py.  Run with a release which writes an older
+UCTCandidate class version to make a reference file for
+data/uctCandidates_v<ClassVersion>.root.
+
+Usage:
+
+    cmsRun writeUCTCandidates_cfg.py outputFile=uctCandidates.root
+
+'''
+
+import FWCore.ParameterSet.Config as cms
+
+from FWCore.ParameterSet.VarParsing import VarParsing
+options = VarParsing ('analysis')
+options.outputFile = "uctCandidates.root"
+options.maxEvents = 10
+options.parseArguments()
+
+process = cms.Process("UCTCandidateIOWrite")
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(options.maxEvents)
+)
+
+process.source = cms.Source("EmptySource")
+
+process.uctCandidates = cms.EDProducer("UCTCandidateIOWriter")
+
+process.p = cms.Path(process.uctCandidates)
+
+process.out = cms.OutputModule(
+    "PoolOutputModule",
+    fileName = cms.untracked.string(options.outputFile),
+    outputCommands = cms.untracked.vstring('drop *', 'keep *_uctCandidates_*_*')
+)
+
+process.outpath = cms.EndPath(process.out)